@@ -28,14 +28,22 @@ namespace sharpSAT {
 
 class AltComponentAnalyzer {
 public:
-	AltComponentAnalyzer(LiteralIndexedVector<TriValue> & lit_values) :
-        literal_values_(lit_values) {
+	AltComponentAnalyzer(LiteralIndexedVector<TriValue> &lit_values,
+      const LiteralIndexedVector<ModelCount> &lit_weights,
+      const VariableIndexedVector<bool> &projection) :
+        literal_values_(lit_values), literal_weights_(lit_weights),
+        projection_(projection) {
   }
 
   unsigned scoreOf(VariableIndex v) {
     return var_frequency_scores_[v];
   }
 
+  // the scores change during the search, which checkpoints save
+  VariableIndexedVector<unsigned> &var_frequency_scores() {
+    return var_frequency_scores_;
+  }
+
   ComponentArchetype &current_archetype(){
     return archetype_;
   }
@@ -79,7 +87,10 @@ public:
        if (isActive(vt->get<VariableIndex>())) {
          archetype_.setVar_in_sup_comp_unseen(vt->get<VariableIndex>());
          var_frequency_scores_[vt->get<VariableIndex>()] = 0;
-       }
+       } else if (!literal_weights_.empty()
+           && inProjection(vt->get<VariableIndex>()))
+         // the variable has been assigned in the current branch of top
+         top.includeSolution(weightOfAssigned(vt->get<VariableIndex>()));
 
      for (auto itCl = super_comp.clsBegin(); itCl->get<ClauseIndex>() != clsSENTINEL; itCl++)
          archetype_.setClause_in_sup_comp_unseen(itCl->get<ClauseIndex>());
@@ -91,7 +102,15 @@ public:
     recordComponentOf(v);
 
     if (search_stack_.size() == 1) {
-      archetype_.stack_level().includeSolution(2);
+      // any value of a variable outside the projection will do
+      if (inProjection(v)) {
+        if (literal_weights_.empty())
+          archetype_.stack_level().includeSolution(2);
+        else
+          archetype_.stack_level().includeSolution(
+              literal_weights_[LiteralID(v, true)]
+              + literal_weights_[LiteralID(v, false)]);
+      }
       archetype_.setVar_in_other_comp(v);
       return false;
     }
@@ -139,6 +158,12 @@ private:
 
   LiteralIndexedVector<TriValue> & literal_values_;
 
+  // empty, unless the formula is weighted
+  const LiteralIndexedVector<ModelCount> &literal_weights_;
+
+  // empty, unless the count is projected
+  const VariableIndexedVector<bool> &projection_;
+
   VariableIndexedVector<unsigned> var_frequency_scores_;
 
   ComponentArchetype  archetype_;
@@ -160,6 +185,18 @@ private:
     return literal_values_[LiteralID(v, true)] == TriValue::X_TRI;
   }
 
+  bool inProjection(const VariableIndex v) {
+    return projection_.empty() || projection_[v];
+  }
+
+  // the weight of the literal of v that is true
+  const ModelCount &weightOfAssigned(const VariableIndex v) {
+    LiteralID lit(v, true);
+    if (literal_values_[lit] != TriValue::T_TRI)
+      lit = lit.neg();
+    return literal_weights_[lit];
+  }
+
   typename std::vector<Variant<ClauseIndex,LiteralID,VariableIndex,unsigned>>::iterator beginOfLinkList(VariableIndex v) {
     return unified_variable_links_lists_pool_.begin() + variable_link_list_offsets_[v];
   }
@@ -0,0 +1,127 @@
+/*
+ * binary_file.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef SHARP_SAT_BINARY_FILE_H_
+#define SHARP_SAT_BINARY_FILE_H_
+
+#include <sharpSAT/input_buffer.h>
+#include <sharpSAT/count_types/model_count.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace sharpSAT {
+
+/*!
+ * Writes the binary files of the solver, like preprocessing snapshots.
+ *
+ * Values are written in native byte order. The data goes to a temporary
+ * file first, which \ref commit() renames, so that readers never see a
+ * partially written file.
+ */
+class BinaryWriter {
+public:
+  explicit BinaryWriter(const std::string &file_name) :
+      file_name_(file_name), tmp_file_name_(file_name + ".tmp"),
+      out_(tmp_file_name_, std::ios::binary) {
+  }
+
+  template<class T>
+  void writeValue(const T &value) {
+    out_.write(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+  template<class T>
+  void writeArray(const T *values, size_t size) {
+    writeValue<uint64_t>(size);
+    out_.write(reinterpret_cast<const char *>(values), size * sizeof(T));
+  }
+
+  template<class T>
+  void writeArray(const std::vector<T> &values) {
+    writeArray(values.data(), values.size());
+  }
+
+  void writeString(const std::string &bytes) {
+    writeValue<uint64_t>(bytes.size());
+    out_.write(bytes.data(), bytes.size());
+  }
+
+  void writeCount(const ModelCount &count) {
+    writeString(count.to_bytes());
+  }
+
+  // returns false if the file could not be written
+  bool commit() {
+    out_.close();
+    if (out_.fail()
+        || std::rename(tmp_file_name_.c_str(), file_name_.c_str()) != 0) {
+      std::remove(tmp_file_name_.c_str());
+      return false;
+    }
+    return true;
+  }
+
+private:
+  std::string file_name_;
+  std::string tmp_file_name_;
+  std::ofstream out_;
+};
+
+/*!
+ * Reads the files written by \ref BinaryWriter.
+ *
+ * All read functions return false if the file ends prematurely or holds
+ * an impossible length.
+ */
+class BinaryReader {
+public:
+  // returns false if the file cannot be read
+  bool open(const std::string &file_name) {
+    return in_.open(file_name);
+  }
+
+  size_t size() const {
+    return in_.size();
+  }
+
+  template<class T>
+  bool readValue(T &value) {
+    return in_.readBytes(&value, sizeof(T));
+  }
+
+  template<class T>
+  bool readArray(std::vector<T> &values) {
+    uint64_t size;
+    // do not allocate more than the file holds
+    if (!readValue(size) || size > in_.size() / sizeof(T))
+      return false;
+    values.resize(size);
+    return in_.readBytes(values.data(), size * sizeof(T));
+  }
+
+  bool readString(std::string &bytes) {
+    uint64_t size;
+    if (!readValue(size) || size > in_.size())
+      return false;
+    bytes.resize(size);
+    return in_.readBytes(&bytes[0], size);
+  }
+
+  bool readCount(ModelCount &count) {
+    std::string bytes;
+    return readString(bytes) && ModelCount::from_bytes(bytes, count);
+  }
+
+private:
+  InputBuffer in_;
+};
+
+} // sharpSAT namespace
+#endif /* BINARY_FILE_H_ */
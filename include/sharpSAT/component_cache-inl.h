@@ -10,7 +10,7 @@
 
 namespace sharpSAT {
 
-CacheEntryID ComponentCache::storeAsEntry(CacheableComponent &ccomp, CacheEntryID super_comp_id){
+CacheEntryID ComponentCache::storeAsEntry(CacheableComponent &&ccomp, CacheEntryID super_comp_id){
     CacheEntryID id;
 
     if (statistics_.cache_full())
@@ -19,19 +19,20 @@ CacheEntryID ComponentCache::storeAsEntry(CacheableComponent &ccomp, CacheEntryI
     assert(!statistics_.cache_full());
 
     ccomp.set_creation_time(my_time_++);
+    CacheableComponent *pentry = newEntry(std::move(ccomp));
 
     if (free_entry_base_slots_.empty()) {
         if (entry_base_.capacity() == entry_base_.size()) {
             entry_base_.reserve(2 * entry_base_.size());
         }
-        entry_base_.push_back(&ccomp);
+        entry_base_.push_back(pentry);
         id = entry_base_.size() - 1;
     } else {
         id = free_entry_base_slots_.back();
         assert(id < entry_base_.size());
         assert(entry_base_[id] == nullptr);
         free_entry_base_slots_.pop_back();
-        entry_base_[id] = &ccomp;
+        entry_base_[id] = pentry;
     }
 
     entry(id).set_father(super_comp_id);
@@ -40,7 +41,7 @@ CacheEntryID ComponentCache::storeAsEntry(CacheableComponent &ccomp, CacheEntryI
     assert(hasEntry(id));
     assert(hasEntry(super_comp_id));
 
-    statistics_.incorporate_cache_store(ccomp);
+    statistics_.incorporate_cache_store(*pentry);
 
   #ifdef DEBUG
       for (unsigned u = 2; u < entry_base_.size(); u++)
@@ -79,30 +80,37 @@ void ComponentCache::cleanPollutionsInvolving(CacheEntryID id) {
   eraseEntry(id);
 }
 
+void ComponentCache::insertIntoHashTable(CacheEntryID id) {
+  unsigned table_ofs = tableEntry(id);
+  while (table_[table_ofs].id)
+    table_ofs = (table_ofs + 1) & table_size_mask_;
+  table_[table_ofs].hashkey = entry(id).hashkey();
+  table_[table_ofs].id = id;
+  num_table_entries_++;
+}
+
 void ComponentCache::removeFromHashTable(CacheEntryID id) {
-  //assert(false);
-  unsigned act_id = table_[tableEntry(id)];
-  if(act_id == id){
-    table_[tableEntry(id)] = entry(act_id).next_bucket_element();
+  unsigned table_ofs = tableEntry(id);
+  while (table_[table_ofs].id != id) {
+    // entries without model count are not in the table
+    if (table_[table_ofs].id == 0)
+      return;
+    table_ofs = (table_ofs + 1) & table_size_mask_;
   }
-  else {
-  while (act_id) {
-        CacheEntryID next_id = entry(act_id).next_bucket_element();
-        if (next_id == id) {
-          entry(act_id).set_next_bucket_element(entry(next_id).next_bucket_element());
-          break;
-        }
-        act_id = next_id;
-      }
+  num_table_entries_--;
+  // shift the following slots of the probe sequence back,
+  // so that no gap is left in it
+  unsigned next_ofs = (table_ofs + 1) & table_size_mask_;
+  while (table_[next_ofs].id) {
+    unsigned home_ofs = table_[next_ofs].hashkey & table_size_mask_;
+    if (((next_ofs - home_ofs) & table_size_mask_)
+        >= ((next_ofs - table_ofs) & table_size_mask_)) {
+      table_[table_ofs] = table_[next_ofs];
+      table_ofs = next_ofs;
+    }
+    next_ofs = (next_ofs + 1) & table_size_mask_;
   }
-//  CacheBucket *p_bucket = bucketOf(entry(id));
-//  if(p_bucket)
-//    for (auto it = p_bucket->begin(); it != p_bucket->end(); it++)
-//      if (*it == id) {
-//        *it = p_bucket->back();
-//        p_bucket->pop_back();
-//        break;
-//      }
+  table_[table_ofs] = TableSlot();
 }
 
 void ComponentCache::removeFromDescendantsTree(CacheEntryID id) {
@@ -139,9 +147,8 @@ void ComponentCache::removeFromDescendantsTree(CacheEntryID id) {
   }
 }
 
-void ComponentCache::storeValueOf(CacheEntryID id, const mpz_class &model_count) {
+void ComponentCache::storeValueOf(CacheEntryID id, const ModelCount &model_count) {
   considerCacheResize();
-  unsigned table_ofs = tableEntry(id);
   // when storing the new model count the size of the model count
   // and hence that of the component will change
   statistics_.sum_bytes_cached_components_ -= entry(id).SizeInBytes();
@@ -153,15 +160,13 @@ void ComponentCache::storeValueOf(CacheEntryID id, const mpz_class &model_count)
   entry(id).set_model_count(model_count,my_time_);
   entry(id).set_creation_time(my_time_);
 
-  entry(id).set_next_bucket_element(table_[table_ofs]);
-  table_[table_ofs] = id;
+  insertIntoHashTable(id);
 
   statistics_.sum_bytes_cached_components_ += entry(id).SizeInBytes();
   statistics_.overall_bytes_components_stored_ += entry(id).SizeInBytes();
 
   statistics_.sys_overhead_sum_bytes_cached_components_ += entry(id).sys_overhead_SizeInBytes();
    statistics_.sys_overhead_overall_bytes_components_stored_ += entry(id).sys_overhead_SizeInBytes();
-
 }
 } // sharpSAT namespace
 #endif /* COMPONENT_CACHE_INL_H_ */
@@ -14,12 +14,21 @@
 #include <sharpSAT/solver_config.h>
 #include <sharpSAT/component_types/component.h>
 #include <sharpSAT/component_types/cacheable_component.h>
+#include <sharpSAT/shared_component_cache.h>
+#include <sharpSAT/containers/slab_allocator.h>
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
 #include <gmpxx.h>
 
 namespace sharpSAT {
 
+class BinaryReader;
+class BinaryWriter;
+
 class ComponentCache {
 public:
 
@@ -29,10 +38,52 @@ public:
    // debug_dump_data();
     for (auto &pentry : entry_base_)
           if (pentry != nullptr)
-            delete pentry;
+            deleteEntry(pentry);
+  }
+
+  // model counts saved to config.cache_file for the formula with the
+  // fingerprint set below are loaded into the cache
+  void init(Component &super_comp, const PackSize &pack_size,
+      SolverConfiguration &config);
+
+  // like init(), but keeps the model counts of all components, which hold
+  // regardless of the assignment the formula is searched under.
+  // Like publishModelCounts() this must not be called before the
+  // search has finished.
+  void restart(Component &super_comp) {
+    // the count of the super component held for the previous assignment
+    removeFromHashTable(1);
+    super_comp.set_id(1);
   }
 
-  void init(Component &super_comp, SolverConfiguration &config);
+  // the fingerprint of the formula, which tells whether a file of
+  // cached model counts applies, 0 if none applies
+  void set_formula_fingerprint(uint64_t fingerprint) {
+    formula_fingerprint_ = fingerprint;
+  }
+
+  // writes all model counts of this cache to file_name, so that the
+  // next init() for the same formula finds them. Like publishModelCounts()
+  // this must not be called before the search has finished.
+  bool saveModelCounts(const std::string &file_name);
+
+  // all entries along with their ids and the descendants tree,
+  // which the components on the stack of a search refer to
+  void writeEntries(BinaryWriter &out);
+  // replaces all entries by those written above,
+  // returns false if the file is corrupt
+  bool readEntries(BinaryReader &in);
+
+  // model counts missing in this cache are looked up in shared_cache
+  void set_shared_cache(SharedComponentCache *shared_cache) {
+    shared_cache_ = shared_cache;
+  }
+
+  // copies all model counts of this cache into the shared cache.
+  // Counts found in a branch that later turns out unsatisfiable may be
+  // too small and are only removed from this cache then, hence this
+  // must not be called before the search has finished.
+  void publishModelCounts();
 
   // compute the size in bytes of the component cache from scratch
   // the value is stored in bytes_memory_usage_
@@ -66,7 +117,7 @@ public:
   // returns the id of the entry created
   // stores in the entry the position of
   // comp which is a part of the component stack
-  inline CacheEntryID storeAsEntry(CacheableComponent &ccomp,
+  inline CacheEntryID storeAsEntry(CacheableComponent &&ccomp,
                             CacheEntryID super_comp_id);
 
   // check quickly if the model count of the component is cached
@@ -74,32 +125,85 @@ public:
   // if not, store the packed version of it in the entry_base of the cache
   bool manageNewComponent(StackLevel &top, CacheableComponent &packed_comp) {
        statistics_.num_cache_look_ups_++;
-       unsigned table_ofs =  packed_comp.hashkey() & table_size_mask_;
-
-       CacheEntryID act_id = table_[table_ofs];
-       while(act_id){
-         if (entry(act_id).equals(packed_comp)) {
-           statistics_.incorporate_cache_hit(packed_comp);
-           top.includeSolution(entry(act_id).model_count());
-           return true;
-         }
-         act_id = entry(act_id).next_bucket_element();
+       CacheEntryID id = findEntry(packed_comp);
+       if (id) {
+         statistics_.incorporate_cache_hit(packed_comp);
+         top.includeSolution(entry(id).model_count());
+         return true;
+       }
+       ModelCount model_count;
+       if (shared_cache_ && shared_cache_->lookUp(packed_comp, model_count)) {
+         statistics_.incorporate_cache_hit(packed_comp);
+         top.includeSolution(model_count);
+         return true;
        }
        return false;
   }
 
 
+  // like manageNewComponent(), but only entries with the marginals or
+  // the NNF node asked for are hit, returns the id of the entry hit, 0 if none
+  CacheEntryID lookUp(CacheableComponent &packed_comp, bool with_marginals,
+      bool with_nnf_node) {
+    statistics_.num_cache_look_ups_++;
+    CacheEntryID id = findEntry(packed_comp, with_marginals, with_nnf_node);
+    if (id)
+      statistics_.incorporate_cache_hit(packed_comp);
+    return id;
+  }
+
+  // the marginals of the component of entry id, see MarginalStack
+  void storeMarginalsOf(CacheEntryID id,
+      const std::vector<ModelCount> &marginals) {
+    if (marginals_.size() < entry_base_.size())
+      marginals_.resize(entry_base_.size());
+    statistics_.sum_bytes_cached_components_ -= marginalsBytes(id);
+    marginals_[id] = marginals;
+    statistics_.sum_bytes_cached_components_ += marginalsBytes(id);
+  }
+
+  bool hasMarginals(CacheEntryID id) const {
+    return id < marginals_.size() && !marginals_[id].empty();
+  }
+
+  const std::vector<ModelCount> &marginalsOf(CacheEntryID id) const {
+    assert(hasMarginals(id));
+    return marginals_[id];
+  }
+
+  // the node of the component of entry id in the NnfTrace
+  void storeNnfNodeOf(CacheEntryID id, unsigned node) {
+    if (nnf_nodes_.size() < entry_base_.size())
+      nnf_nodes_.resize(entry_base_.size(), 0);
+    nnf_nodes_[id] = node + 1;
+  }
+
+  bool hasNnfNode(CacheEntryID id) const {
+    return id < nnf_nodes_.size() && nnf_nodes_[id] != 0;
+  }
+
+  unsigned nnfNodeOf(CacheEntryID id) const {
+    assert(hasNnfNode(id));
+    return nnf_nodes_[id] - 1;
+  }
+
   // unchecked erase of an entry from entry_base_
   void eraseEntry(CacheEntryID id) {
+    if (id < nnf_nodes_.size())
+      nnf_nodes_[id] = 0;
+    if (hasMarginals(id)) {
+      statistics_.sum_bytes_cached_components_ -= marginalsBytes(id);
+      std::vector<ModelCount>().swap(marginals_[id]);
+    }
     statistics_.incorporate_cache_erase(*entry_base_[id]);
-    delete entry_base_[id];
+    deleteEntry(entry_base_[id]);
     entry_base_[id] = nullptr;
     free_entry_base_slots_.push_back(id);
   }
 
 
   // store the number in model_count as the model count of CacheEntryID id
-  inline void storeValueOf(CacheEntryID id, const mpz_class &model_count);
+  inline void storeValueOf(CacheEntryID id, const ModelCount &model_count);
 
   bool deleteEntries();
 
@@ -111,34 +215,85 @@ public:
   void debug_dump_data();
 private:
 
+  // the entry in the table that holds the count of packed_comp, 0 if none
+  CacheEntryID findEntry(CacheableComponent &packed_comp,
+      bool with_marginals = false, bool with_nnf_node = false) {
+    unsigned hashkey = packed_comp.hashkey();
+    for (unsigned table_ofs = hashkey & table_size_mask_; table_[table_ofs].id;
+        table_ofs = (table_ofs + 1) & table_size_mask_) {
+      CacheEntryID id = table_[table_ofs].id;
+      // most mismatches are rejected without touching the entry
+      if (table_[table_ofs].hashkey == hashkey
+          && (!with_marginals || hasMarginals(id))
+          && (!with_nnf_node || hasNnfNode(id))
+          && entry(id).equals(packed_comp))
+        return id;
+    }
+    return 0;
+  }
+
+  uint64_t marginalsBytes(CacheEntryID id) const {
+    if (id >= marginals_.size())
+      return 0;
+    uint64_t bytes = sizeof(ModelCount) * marginals_[id].capacity();
+    for (auto &marginal : marginals_[id])
+      bytes += marginal.heap_byte_size();
+    return bytes;
+  }
+
+  // moves ccomp into the entry slabs and its data into the data slabs
+  CacheableComponent *newEntry(CacheableComponent &&ccomp) {
+    CacheableComponent *pentry =
+        new (entry_slabs_.allocate(1)) CacheableComponent(std::move(ccomp));
+    if (pentry->data()) {
+      unsigned *data = data_slabs_.allocate(pentry->data_size());
+      std::copy(pentry->data(), pentry->data() + pentry->data_size(), data);
+      delete[] pentry->release_data();
+      pentry->set_data(data);
+    }
+    return pentry;
+  }
+
+  void deleteEntry(CacheableComponent *pentry) {
+    if (pentry->data())
+      data_slabs_.deallocate(pentry->release_data(), pentry->data_size());
+    pentry->~CacheableComponent();
+    entry_slabs_.deallocate(pentry, 1);
+  }
+
+  // moves all entries and their data into fresh slabs,
+  // so that the memory of erased entries is given back
+  void compactSlabs();
+
+  // the table is kept at most half full,
+  // so that probe sequences stay short
   void considerCacheResize(){
-    if (entry_base_.size() > table_.size()) {
+    if (2 * (num_table_entries_ + 1) > table_.size()) {
       reHashTable(2*table_.size());
     }
   }
   void reHashTable(unsigned size){
 
     table_.clear();
-    table_.resize(size,0);
+    table_.resize(size);
     // we assert that table size is a power of 2
     // otherwise the table_size_mask_ doesn't work
     assert((table_.size() & (table_.size() - 1)) == 0);
     table_size_mask_ = table_.size() - 1;
-    // cout << "ts " << table_.size() << " " << table_size_mask_ << endl;
-    unsigned collisions = 0;
+    num_table_entries_ = 0;
     for (unsigned id = 2; id < entry_base_.size(); id++)
-      if (entry_base_[id] != nullptr ){
-        entry_base_[id]->set_next_bucket_element(0);
-       if(entry_base_[id]->modelCountFound()) {
-        unsigned table_ofs=tableEntry(id);
-        collisions += (table_[table_ofs] > 0 ? 1 : 0);
-        entry_base_[id]->set_next_bucket_element(table_[table_ofs]);
-        table_[table_ofs] = id;
-       }
-    }
-    // cout << "coll " << collisions << endl;
+      if (entry_base_[id] != nullptr && entry_base_[id]->modelCountFound())
+        insertIntoHashTable(id);
   }
 
+  inline void insertIntoHashTable(CacheEntryID id);
+
+  // key of the files of model counts for the current formula
+  std::string modelCountsKey() const;
+
+  // returns the number of model counts loaded
+  unsigned loadModelCounts(const std::string &file_name);
+
   unsigned tableEntry(CacheEntryID id){
     return entry(id).hashkey() & table_size_mask_;
   }
@@ -155,16 +310,37 @@ private:
     }
 
   std::vector<CacheableComponent *> entry_base_;
+  SlabAllocator<CacheableComponent> entry_slabs_;
+  SlabAllocator<unsigned> data_slabs_;
   std::vector<CacheEntryID> free_entry_base_slots_;
 
+  // a slot of the hash table, id 0 marks an empty slot
+  struct TableSlot {
+    unsigned hashkey = 0;
+    CacheEntryID id = 0;
+  };
+
   // the actual hash table
-  // by means of which the cache is accessed
-  std::vector<CacheEntryID> table_;
+  // by means of which the cache is accessed,
+  // collisions are resolved by linear probing
+  std::vector<TableSlot> table_;
 
   unsigned table_size_mask_;
 
+  // the number of occupied slots in table_
+  unsigned num_table_entries_ = 0;
+
   DataAndStatistics &statistics_;
 
+  // indexed by CacheEntryID, empty unless marginals are stored
+  std::vector<std::vector<ModelCount>> marginals_;
+  // the node of each entry plus 1, 0 for none
+  std::vector<unsigned> nnf_nodes_;
+
+  SharedComponentCache *shared_cache_ = nullptr;
+
+  uint64_t formula_fingerprint_ = 0;
+
   unsigned long my_time_ = 0;
 };
 } // sharpSAT namespace
@@ -13,6 +13,8 @@
 #include <sharpSAT/alt_component_analyzer.h>
 #include <sharpSAT/component_cache.h>
 #include <sharpSAT/containers.h>
+#include <sharpSAT/marginal_stack.h>
+#include <sharpSAT/nnf_trace.h>
 #include <sharpSAT/stack.h>
 #include <sharpSAT/solver_config.h>
 #include <sharpSAT/component_types/component.h>
@@ -28,9 +30,11 @@ typedef AltComponentAnalyzer ComponentAnalyzer;
 class ComponentManager {
 public:
   ComponentManager(SolverConfiguration &config, DataAndStatistics &statistics,
-        LiteralIndexedVector<TriValue> & lit_values) :
+        LiteralIndexedVector<TriValue> & lit_values,
+        const LiteralIndexedVector<ModelCount> &lit_weights,
+        const VariableIndexedVector<bool> &projection) :
         config_(config), cache_(statistics),
-        ana_(lit_values) {
+        ana_(lit_values, lit_weights, projection) {
   }
   ~ComponentManager() {
       for (auto* ptr : component_stack_) {
@@ -41,15 +45,71 @@ public:
   void initialize(LiteralIndexedVector<Literal> & literals,
         std::vector<LiteralID> &lit_pool);
 
+  // same as above, but the search is restricted to root_comp
+  // instead of the whole formula
+  void initialize(LiteralIndexedVector<Literal> & literals,
+        std::vector<LiteralID> &lit_pool, const Component &root_comp);
+
+  // searches the whole formula again, e.g. under other assumptions,
+  // with the model counts cached by the previous search
+  void reinitialize();
+
+  void setSharedCache(SharedComponentCache *shared_cache) {
+    cache_.set_shared_cache(shared_cache);
+  }
+
+  void publishCachedModelCounts() {
+    cache_.publishModelCounts();
+  }
+
+  // model counts cached for the formula with this fingerprint in
+  // config_.cache_file are loaded by initialize()
+  void setFormulaFingerprint(uint64_t fingerprint) {
+    cache_.set_formula_fingerprint(fingerprint);
+  }
+
+  bool saveCachedModelCounts() {
+    return cache_.saveModelCounts(config_.cache_file);
+  }
+
+  // the component stack, the cache and the branching scores
+  // of a search, which is resumed once they are read back
+  void writeSearchState(BinaryWriter &out);
+  // returns false if the file is corrupt
+  bool readSearchState(BinaryReader &in);
+
+  // if set, components are taken from the cache only along with their
+  // marginals, which are included into marginal_stack
+  void setMarginalStack(MarginalStack *marginal_stack) {
+    marginal_stack_ = marginal_stack;
+  }
+
+  // likewise for the nodes of components in nnf_trace
+  void setNnfTrace(NnfTrace *nnf_trace) {
+    nnf_trace_ = nnf_trace;
+  }
+
   unsigned scoreOf(VariableIndex v) {
       return ana_.scoreOf(v);
   }
 
-  void cacheModelCountOf(unsigned stack_comp_id, const mpz_class &value) {
+  void cacheModelCountOf(unsigned stack_comp_id, const ModelCount &value) {
     if (config_.perform_component_caching)
       cache_.storeValueOf(component_stack_[stack_comp_id]->id(), value);
   }
 
+  void cacheMarginalsOf(unsigned stack_comp_id,
+      const std::vector<ModelCount> &marginals) {
+    if (config_.perform_component_caching)
+      cache_.storeMarginalsOf(component_stack_[stack_comp_id]->id(),
+          marginals);
+  }
+
+  void cacheNnfNodeOf(unsigned stack_comp_id, unsigned node) {
+    if (config_.perform_component_caching)
+      cache_.storeNnfNodeOf(component_stack_[stack_comp_id]->id(), node);
+  }
+
   Component & superComponentOf(StackLevel &lev) {
     assert(component_stack_.size() > lev.super_component());
     return *component_stack_[lev.super_component()];
@@ -69,6 +129,11 @@ public:
     assert(top.remaining_components_ofs() <= component_stack_.size());
   }
 
+  Component & componentAt(unsigned stack_comp_id) {
+    assert(component_stack_.size() > stack_comp_id);
+    return *component_stack_[stack_comp_id];
+  }
+
   Component & currentRemainingComponentOf(StackLevel &top) {
     assert(component_stack_.size() > top.currentRemainingComponent());
     return *component_stack_[top.currentRemainingComponent()];
@@ -92,13 +157,44 @@ public:
 
   void removeAllCachePollutionsOf(StackLevel &top);
 
+  // if top has just recorded at least two remaining components
+  // of min_vars or more variables, all but the largest of these
+  // are marked processed, so that they can be counted elsewhere.
+  // Their positions in the component stack are stored in comp_ids.
+  void detachRemainingCompsOf(StackLevel &top, unsigned min_vars,
+        std::vector<unsigned> &comp_ids);
+
 private:
 
+  void initializeComponentStack(Component *root_comp);
+  void resetComponentStack(Component *root_comp);
+
+  // like ComponentCache::manageNewComponent(),
+  // for the marginals and the NNF node of comp as well
+  bool manageNewComponentWithExtras(StackLevel &top, const Component &comp,
+      CacheableComponent &packed_comp) {
+    CacheEntryID id = cache_.lookUp(packed_comp, marginal_stack_ != nullptr,
+        nnf_trace_ != nullptr);
+    if (!id)
+      return false;
+    top.includeSolution(cache_.entry(id).model_count());
+    if (marginal_stack_)
+      marginal_stack_->includeComponent(cache_.entry(id).model_count(), comp,
+          cache_.marginalsOf(id));
+    if (nnf_trace_)
+      nnf_trace_->includeNode(cache_.nnfNodeOf(id));
+    return true;
+  }
+
   SolverConfiguration &config_;
 
   std::vector<Component *> component_stack_;
+  PackSize pack_size_;
   ComponentCache cache_;
   ComponentAnalyzer ana_;
+
+  MarginalStack *marginal_stack_ = nullptr;
+  NnfTrace *nnf_trace_ = nullptr;
 };
 
 
@@ -146,7 +242,9 @@ bool ComponentManager::findNextRemainingComponentOf(StackLevel &top) {
     // record Remaining Components if there are none!
     if (component_stack_.size() <= top.remaining_components_ofs())
       recordRemainingCompsFor(top);
-    assert(!top.branch_found_unsat());
+    // a literal of weight 0 makes the branch count 0
+    if (top.branch_found_unsat())
+      return false;
     if (top.hasUnprocessedComponents())
       return true;
     // if no component remains
@@ -167,13 +265,14 @@ void ComponentManager::recordRemainingCompsFor(StackLevel &top) {
          ana_.exploreRemainingCompOf(vt->get<VariableIndex>())) {
 
        Component *p_new_comp = ana_.makeComponentFromArcheType();
-       CacheableComponent *packed_comp = new CacheableComponent(ana_.getArchetype().current_comp_for_caching_);
-         if (!cache_.manageNewComponent(top, *packed_comp)){
+       CacheableComponent packed_comp(ana_.getArchetype().current_comp_for_caching_, pack_size_);
+         if (marginal_stack_ || nnf_trace_
+             ? !manageNewComponentWithExtras(top, *p_new_comp, packed_comp)
+             : !cache_.manageNewComponent(top, packed_comp)) {
             component_stack_.push_back(p_new_comp);
-            p_new_comp->set_id(cache_.storeAsEntry(*packed_comp, super_comp.id()));
+            p_new_comp->set_id(cache_.storeAsEntry(std::move(packed_comp), super_comp.id()));
          }
          else {
-           delete packed_comp;
            delete p_new_comp;
          }
      }
@@ -9,10 +9,12 @@
 #define SHARP_SAT_BASE_PACKED_COMPONENT_H_
 
 #include <sharpSAT/primitive_types.h>
+#include <sharpSAT/count_types/model_count.h>
 
 #include <assert.h>
+#include <algorithm>
 #include <cstddef>
-#include <gmpxx.h>
+#include <utility>
 
 namespace sharpSAT {
 
@@ -61,31 +63,53 @@ template <class T>
 };
 
 
-class BasePackedComponent {
+// the number of bits needed to pack a variable or clause index
+// of the formula a solver works on
+class PackSize {
 public:
-  static unsigned bits_per_variable() {
-    return _bits_per_variable;
-  }
-  static unsigned variable_mask() {
-      return _variable_mask;
+  PackSize() {}
+  PackSize(VariableIndex maxVarId, ClauseIndex maxClId);
+
+  unsigned bits_per_variable() const {
+    return bits_per_variable_;
   }
-  static unsigned bits_per_clause() {
-    return _bits_per_clause;
+  unsigned bits_per_clause() const {
+    return bits_per_clause_;
   }
 
+private:
+  unsigned bits_per_variable_ = 0;
+  unsigned bits_per_clause_ = 0;
+};
+
+
+class BasePackedComponent {
+public:
   static unsigned bits_per_block(){
 	  return _bits_per_block;
   }
 
-  static unsigned bits_of_data_size(){
-    return _bits_of_data_size;
-  }
-
-  static void adjustPackSize(VariableIndex maxVarId, ClauseIndex maxClId);
-
   BasePackedComponent() {}
   BasePackedComponent(unsigned creation_time): creation_time_(creation_time) {}
 
+  // a copy of packed data, as read from a file
+  BasePackedComponent(const unsigned *data, unsigned data_size,
+      unsigned hashkey) :
+      data_(new unsigned[data_size]), hashkey_(hashkey),
+      data_size_(data_size) {
+    std::copy(data, data + data_size, data_);
+  }
+
+  BasePackedComponent(BasePackedComponent &&other) :
+      data_(other.data_), hashkey_(other.hashkey_),
+      data_size_(other.data_size_),
+      model_count_(std::move(other.model_count_)),
+      creation_time_(other.creation_time_),
+      length_solution_period_and_flags_(
+          other.length_solution_period_and_flags_) {
+    other.data_ = nullptr;
+  }
+
   ~BasePackedComponent() {
     if (data_)
       delete[] data_;
@@ -125,20 +149,19 @@ public:
     return creation_time_;
   }
 
-  const mpz_class &model_count() const {
+  const ModelCount &model_count() const {
     return model_count_;
   }
 
   unsigned alloc_of_model_count() const{
-        return sizeof(mpz_class)
-               + model_count_.get_mpz_t()->_mp_alloc * sizeof(mp_limb_t);
+        return sizeof(ModelCount) + model_count_.heap_byte_size();
   }
 
   void set_creation_time(unsigned time) {
     creation_time_ = time;
   }
 
-  void set_model_count(const mpz_class &rn, unsigned time) {
+  void set_model_count(const ModelCount &rn, unsigned time) {
     model_count_ = rn;
     length_solution_period_and_flags_ = (time - creation_time_) | (length_solution_period_and_flags_ & 1);
   }
@@ -147,6 +170,23 @@ public:
     return hashkey_;
   }
 
+  const unsigned *data() const {
+    return data_;
+  }
+
+  // data_ is not deleted by this component from now on
+  unsigned *release_data() {
+    unsigned *data = data_;
+    data_ = nullptr;
+    return data;
+  }
+
+  // data has to be a copy of data(), the caller remains its owner,
+  // i.e. it has to call release_data() before the component is destroyed
+  void set_data(unsigned *data) {
+    data_ = data;
+  }
+
   bool modelCountFound(){
     return (length_solution_period_and_flags_ >> 1);
   }
@@ -163,28 +203,28 @@ public:
     length_solution_period_and_flags_ |= 1;
   }
 
-  void clear() {
-    // before deleting the contents of this component,
-    // we should make sure that this component is not present in the component stack anymore!
-    assert(isDeletable());
-    if (data_)
-      delete[] data_;
-    data_ = nullptr;
+  // both of the above, as saved by checkpoints
+  unsigned length_solution_period_and_flags() const {
+    return length_solution_period_and_flags_;
+  }
+  void set_length_solution_period_and_flags(unsigned value) {
+    length_solution_period_and_flags_ = value;
   }
-
-  static unsigned _debug_static_val;
 
 protected:
   // data_ contains in packed form the variable indices
   // and clause indices of the component ordered
   // structure is
-  // var var ... clause clause ...
+  // num_variables var var ... clause clause ...
   // clauses begin at clauses_ofs_
   unsigned* data_ = nullptr;
 
   unsigned hashkey_ = 0;
 
-  mpz_class model_count_;
+  // the number of unsigned blocks in data_
+  unsigned data_size_ = 0;
+
+  ModelCount model_count_;
 
   unsigned creation_time_ = 1;
 
@@ -200,10 +240,6 @@ protected:
 
 
 protected:
-  static unsigned _bits_per_clause, _bits_per_variable; // bitsperentry
-  static unsigned _bits_of_data_size; // number of bits needed to store the data size
-  static unsigned _data_size_mask;
-  static unsigned _variable_mask, _clause_mask;
   static const unsigned _bits_per_block= (sizeof(unsigned) << 3);
 
 };
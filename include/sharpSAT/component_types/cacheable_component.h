@@ -31,8 +31,13 @@ public:
   GenericCacheableComponent() {
   }
 
-  GenericCacheableComponent(Component &comp) :
-      T_Component(comp) {
+  GenericCacheableComponent(Component &comp, const PackSize &pack_size) :
+      T_Component(comp, pack_size) {
+  }
+
+  GenericCacheableComponent(const unsigned *data, unsigned data_size,
+      unsigned hashkey) :
+      T_Component(data, data_size, hashkey) {
   }
 
   unsigned long SizeInBytes() const {
@@ -40,14 +45,13 @@ public:
         + T_Component::raw_data_byte_size();
   }
 
-  // the 48 = 16*3 in overhead stems from the three parts of the component
-  // being dynamically allocated (i.e. the GenericCacheableComponent itself,
-  // the data_ and the model_count data
+  // the GenericCacheableComponent itself and its data_ are kept
+  // in the slabs of the cache, so the 32 = 16*2 in overhead stems only
+  // from a model count promoted to the heap (the mpz_class and its limbs)
   unsigned long sys_overhead_SizeInBytes() const {
       return sizeof(GenericCacheableComponent<T_Component>)
           + T_Component::sys_overhead_raw_data_byte_size()
-         // + 24;
-          +48;
+          + (T_Component::model_count().heap_byte_size() ? 32 : 0);
     }
 
   // BEGIN Cache Pollution Management
@@ -74,19 +78,8 @@ public:
   }
 
 
-
-  void set_next_bucket_element(CacheEntryID entry) {
-    next_bucket_element_ = entry;
-  }
-
-  CacheEntryID next_bucket_element() {
-      return next_bucket_element_;
-  }
-
 private:
 
-  CacheEntryID next_bucket_element_ = 0;
-
   // theFather and theDescendants:
   // each CCacheEntry is a Node in a tree which represents the relationship
   // of the components stored
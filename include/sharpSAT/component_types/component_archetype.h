@@ -17,6 +17,7 @@
 
 #include <cstring>
 #include <algorithm>
+#include <vector>
 
 
 namespace sharpSAT {
@@ -167,19 +168,16 @@ public:
     return seen(cl) & CA_SearchState::CL_IN_OTHER_COMP;
   }
 
-  static void initArrays(VariableIndex max_variable_id, ClauseIndex max_clause_id) {
+  void initArrays(VariableIndex max_variable_id, ClauseIndex max_clause_id) {
     unsigned seen_size = std::max(
       static_cast<unsigned>(max_variable_id),
       static_cast<unsigned>(max_clause_id)
     ) + 1;
-    seen_ = new CA_SearchState[seen_size];
-    seen_byte_size_ = sizeof(CA_SearchState) * (seen_size);
-    clearArrays();
-
+    seen_.assign(seen_size, CA_SearchState::NIL);
   }
 
-  static void clearArrays() {
-    memset(seen_, CA_SearchState::NIL, seen_byte_size_);
+  void clearArrays() {
+    std::fill(seen_.begin(), seen_.end(), CA_SearchState::NIL);
   }
 
 
@@ -236,16 +234,15 @@ private:
   Component *p_super_comp_;
   StackLevel *p_stack_level_;
 
-  static CA_SearchState& seen(VariableIndex var) {
+  CA_SearchState& seen(VariableIndex var) {
     return seen_[static_cast<unsigned>(var)];
   }
 
-  static CA_SearchState& seen(ClauseIndex cl) {
+  CA_SearchState& seen(ClauseIndex cl) {
     return seen_[static_cast<unsigned>(cl)];
   }
 
-  static CA_SearchState *seen_;
-  static unsigned seen_byte_size_;
+  std::vector<CA_SearchState> seen_;
 
 };
 
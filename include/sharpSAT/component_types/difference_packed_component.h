@@ -21,16 +21,19 @@ public:
   DifferencePackedComponent() {
   }
 
-  inline DifferencePackedComponent(Component &rComp);
+  inline DifferencePackedComponent(Component &rComp, const PackSize &pack_size);
 
-  unsigned num_variables() const{
-    uint64_t *p = (uint64_t *) data_;
-    return (*p >> bits_of_data_size()) & (uint64_t) variable_mask();
+  DifferencePackedComponent(const unsigned *data, unsigned data_size,
+      unsigned hashkey) :
+      BasePackedComponent(data, data_size, hashkey) {
+  }
 
+  unsigned num_variables() const{
+    return *data_;
   }
 
   unsigned data_size() const {
-         return *data_ & _data_size_mask;
+         return data_size_;
     }
 
   unsigned data_only_byte_size() const {
@@ -39,24 +42,22 @@ public:
 
     unsigned raw_data_byte_size() const {
           return data_size()* sizeof(unsigned)
-               + model_count_.get_mpz_t()->_mp_alloc * sizeof(mp_limb_t);
+               + model_count_.heap_byte_size();
     }
 
     // raw data size with the overhead
-    // for the supposed 16byte alignment of malloc
+    // for the supposed 16byte alignment of malloc,
+    // data_ is cut from a slab and hence not aligned
     unsigned sys_overhead_raw_data_byte_size() const {
       unsigned ds = data_size()* sizeof(unsigned);
-      unsigned ms = model_count_.get_mpz_t()->_mp_alloc * sizeof(mp_limb_t);
-//      unsigned mask = 0xfffffff8;
-//      return (ds & mask) + ((ds & 7)?8:0)
-//            +(ms & mask) + ((ms & 7)?8:0);
+      unsigned ms = model_count_.heap_byte_size();
       unsigned mask = 0xfffffff0;
-            return (ds & mask) + ((ds & 15)?16:0)
+            return ds
                   +(ms & mask) + ((ms & 15)?16:0);
     }
 
   bool equals(const DifferencePackedComponent &comp) const {
-    if(hashkey_ != comp.hashkey())
+    if(hashkey_ != comp.hashkey() || data_size_ != comp.data_size_)
       return false;
     unsigned* p = data_;
     unsigned* r = comp.data_;
@@ -73,7 +74,8 @@ private:
 
 
 
-DifferencePackedComponent::DifferencePackedComponent(Component &rComp) {
+DifferencePackedComponent::DifferencePackedComponent(Component &rComp,
+    const PackSize &pack_size) {
 
   unsigned max_var_diff = 0;
   unsigned hashkey_vars = static_cast<unsigned>(*rComp.varsBegin());
@@ -108,26 +110,26 @@ DifferencePackedComponent::DifferencePackedComponent(Component &rComp) {
   assert(bits_per_var_diff <= 31);
   assert(bits_per_clause_diff <= 31);
 
-  unsigned data_size_vars = bits_of_data_size() + 2*bits_per_variable() + 5;
+  unsigned data_size_vars = pack_size.bits_per_variable() + 5;
 
   data_size_vars += (rComp.num_variables() - 1) * bits_per_var_diff ;
 
   unsigned data_size_clauses = 0;
   if (rComp.clsBegin()->get<ClauseIndex>() != clsSENTINEL)
-    data_size_clauses += bits_per_clause() + 5
+    data_size_clauses += pack_size.bits_per_clause() + 5
        + (rComp.numLongClauses() - 1) * bits_per_clause_diff;
 
-  unsigned data_size = (data_size_vars + data_size_clauses + bits_per_block() - 1) / bits_per_block();
+  // the first block holds the number of variables
+  unsigned data_size = 1 + (data_size_vars + data_size_clauses + bits_per_block() - 1) / bits_per_block();
 
   data_ = new unsigned[data_size];
+  data_size_ = data_size;
+  *data_ = rComp.num_variables();
 
-  assert((data_size >> bits_of_data_size()) == 0);
-  BitStuffer<unsigned> bs(data_);
+  BitStuffer<unsigned> bs(data_ + 1);
 
-  bs.stuff(data_size, bits_of_data_size());
-  bs.stuff(rComp.num_variables(), bits_per_variable());
   bs.stuff(bits_per_var_diff, 5);
-  bs.stuff(static_cast<unsigned>(*rComp.varsBegin()), bits_per_variable());
+  bs.stuff(static_cast<unsigned>(*rComp.varsBegin()), pack_size.bits_per_variable());
 
   if(bits_per_var_diff)
   for (auto it = rComp.varsBegin() + 1; it->get<VariableIndex>() != varsSENTINEL; it++) {
@@ -140,7 +142,7 @@ DifferencePackedComponent::DifferencePackedComponent(Component &rComp) {
 
   if (rComp.clsBegin()->get<ClauseIndex>() != clsSENTINEL) {
     bs.stuff(bits_per_clause_diff, 5);
-    bs.stuff(static_cast<unsigned>(*rComp.clsBegin()), bits_per_clause());
+    bs.stuff(static_cast<unsigned>(*rComp.clsBegin()), pack_size.bits_per_clause());
     if(bits_per_clause_diff)
      for (auto jt = rComp.clsBegin() + 1; jt->get<ClauseIndex>() != clsSENTINEL; jt++) {
       auto star_jt = static_cast<unsigned>(jt->get<ClauseIndex>());
@@ -154,7 +156,7 @@ DifferencePackedComponent::DifferencePackedComponent(Component &rComp) {
   //bs.end_check(bits_per_clause());
   // this will tell us if we computed the data_size
   // correctly
-  bs.assert_size(data_size);
+  bs.assert_size(data_size - 1);
 }
 
 
@@ -20,15 +20,14 @@ public:
   SimplePackedComponent() {
   }
 
-  inline SimplePackedComponent(Component &rComp);
+  inline SimplePackedComponent(Component &rComp, const PackSize &pack_size);
 
   unsigned num_variables() const{
-    uint64_t *p = (uint64_t *) data_;
-    return (*p >> bits_of_data_size()) & (uint64_t) variable_mask();
+    return *data_;
   }
 
   unsigned data_size() const {
-       return *data_ & _data_size_mask;
+       return data_size_;
   }
 
   unsigned data_only_byte_size() const {
@@ -37,11 +36,11 @@ public:
 
   unsigned raw_data_byte_size() const {
         return data_size()* sizeof(unsigned)
-             + model_count_.get_mpz_t()->_mp_alloc * sizeof(mp_limb_t);
+             + model_count_.heap_byte_size();
   }
 
   bool equals(const SimplePackedComponent &comp) const {
-    if(hashkey_ != comp.hashkey())
+    if(hashkey_ != comp.hashkey() || data_size_ != comp.data_size_)
       return false;
     unsigned* p = data_;
     unsigned* r = comp.data_;
@@ -54,35 +53,34 @@ public:
 
 };
 
-SimplePackedComponent::SimplePackedComponent(Component &rComp) {
-  unsigned data_size_vars = bits_of_data_size() + bits_per_variable() + rComp.num_variables() * bits_per_variable();
-  unsigned data_size_clauses = rComp.numLongClauses() * bits_per_clause();
-  unsigned data_size = (data_size_vars + data_size_clauses)/bits_per_block();
+SimplePackedComponent::SimplePackedComponent(Component &rComp,
+    const PackSize &pack_size) {
+  unsigned data_size_vars = rComp.num_variables() * pack_size.bits_per_variable();
+  unsigned data_size_clauses = rComp.numLongClauses() * pack_size.bits_per_clause();
+  // the first block holds the number of variables
+  unsigned data_size = 1 + (data_size_vars + data_size_clauses)/bits_per_block();
 
   data_size+=  ((data_size_vars + data_size_clauses) % bits_per_block())? 1 : 0;
 
   data_ =  new unsigned[data_size];
+  data_size_ = data_size;
+  *data_ = rComp.num_variables();
 
-  BitStuffer<unsigned> bs(data_);
+  BitStuffer<unsigned> bs(data_ + 1);
   unsigned hashkey_vars = 0;
   unsigned hashkey_clauses = 0;
 
-  assert((data_size >> bits_of_data_size()) == 0);
-
-  bs.stuff(data_size, bits_of_data_size());
-  bs.stuff(rComp.num_variables(),bits_per_variable());
-
   for (auto it = rComp.varsBegin(); *it != varsSENTINEL; it++) {
     hashkey_vars = (hashkey_vars *3) + *it;
-    bs.stuff(*it, bits_per_variable());
+    bs.stuff(*it, pack_size.bits_per_variable());
   }
 
   if (*rComp.clsBegin())
     for (auto jt = rComp.clsBegin(); *jt != clsSENTINEL; jt++) {
       hashkey_clauses = (hashkey_clauses *3) + *jt;
-      bs.stuff(*jt, bits_per_clause());
+      bs.stuff(*jt, pack_size.bits_per_clause());
     }
-  bs.assert_size(data_size);
+  bs.assert_size(data_size - 1);
 
   hashkey_ = hashkey_vars + (((unsigned) hashkey_clauses) << 16);
 }
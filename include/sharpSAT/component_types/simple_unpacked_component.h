@@ -20,7 +20,8 @@ public:
   SimpleUnpackedComponent() {
   }
 
-  inline SimpleUnpackedComponent(Component &rComp);
+  // the indices are not packed, hence the PackSize is not needed
+  inline SimpleUnpackedComponent(Component &rComp, const PackSize &);
 
   unsigned num_variables() {
       return *(data_+1);
@@ -36,7 +37,7 @@ public:
 
   unsigned raw_data_byte_size() const {
         return data_size()* sizeof(unsigned)
-             + model_count_.get_mpz_t()->_mp_alloc * sizeof(mp_limb_t);
+             + model_count_.heap_byte_size();
   }
 
   bool equals(const SimpleUnpackedComponent &comp) const {
@@ -53,7 +54,8 @@ public:
 };
 
 
-SimpleUnpackedComponent::SimpleUnpackedComponent(Component &rComp) {
+SimpleUnpackedComponent::SimpleUnpackedComponent(Component &rComp,
+    const PackSize &) {
 
   unsigned data_size = rComp.num_variables() +  rComp.numLongClauses() + 2;
 
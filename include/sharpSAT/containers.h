@@ -53,6 +53,7 @@ public:
 	using std::vector<_T>::end;
 	using std::vector<_T>::size;
 	using std::vector<_T>::clear;
+	using std::vector<_T>::empty;
 	using std::vector<_T>::push_back;
 }; // LiteralIndexedVector
 
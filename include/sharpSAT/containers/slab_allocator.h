@@ -0,0 +1,114 @@
+/*
+ * slab_allocator.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef SHARP_SAT_SLAB_ALLOCATOR_H_
+#define SHARP_SAT_SLAB_ALLOCATOR_H_
+
+#include <assert.h>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace sharpSAT {
+
+/*!
+ * Hands out uninitialized arrays of T, cut from large slabs of memory.
+ *
+ * Arrays of up to max_pooled_size() elements come from the slabs.
+ * Freed arrays go to one free list per size and are reused for arrays
+ * of the same size. Larger arrays are taken from the heap directly.
+ * This avoids the per-allocation overhead of malloc for the many small
+ * arrays of the component cache.
+ *
+ * Slab memory is only returned as a whole, when the allocator is
+ * destroyed. Hence a heavily fragmented allocator is best compacted by
+ * moving all live arrays to a fresh one and swapping the two.
+ */
+template <class T>
+class SlabAllocator {
+public:
+  SlabAllocator() {}
+
+  SlabAllocator(const SlabAllocator&) = delete;
+  SlabAllocator &operator=(const SlabAllocator&) = delete;
+
+  ~SlabAllocator() {
+    for (auto slab : slabs_)
+      ::operator delete(slab);
+  }
+
+  static unsigned max_pooled_size() {
+    return max_pooled_size_;
+  }
+
+  static bool pooled(unsigned size) {
+    return size <= max_pooled_size_;
+  }
+
+  T *allocate(unsigned size) {
+    assert(size > 0);
+    if (!pooled(size))
+      return static_cast<T *>(::operator new(size * sizeof(T)));
+    if (free_lists_.size() > size && !free_lists_[size].empty()) {
+      T *p = free_lists_[size].back();
+      free_lists_[size].pop_back();
+      num_free_elements_ -= size;
+      return p;
+    }
+    if (slab_used_ + size > slab_size_) {
+      // the rest of the current slab is not used anymore
+      num_free_elements_ -= slab_size_ - slab_used_;
+      slabs_.push_back(static_cast<T *>(::operator new(slab_size_ * sizeof(T))));
+      slab_used_ = 0;
+      num_free_elements_ += slab_size_;
+    }
+    T *p = slabs_.back() + slab_used_;
+    slab_used_ += size;
+    num_free_elements_ -= size;
+    return p;
+  }
+
+  void deallocate(T *p, unsigned size) {
+    if (!pooled(size)) {
+      ::operator delete(p);
+      return;
+    }
+    if (free_lists_.size() <= size)
+      free_lists_.resize(size + 1);
+    free_lists_[size].push_back(p);
+    num_free_elements_ += size;
+  }
+
+  // the bytes held in slabs, but not handed out
+  uint64_t bytes_free() const {
+    uint64_t free_list_bytes = 0;
+    for (auto &free_list : free_lists_)
+      free_list_bytes += free_list.capacity() * sizeof(T *);
+    return num_free_elements_ * sizeof(T) + free_list_bytes;
+  }
+
+  void swap(SlabAllocator &other) {
+    std::swap(slabs_, other.slabs_);
+    std::swap(slab_used_, other.slab_used_);
+    std::swap(free_lists_, other.free_lists_);
+    std::swap(num_free_elements_, other.num_free_elements_);
+  }
+
+private:
+  static const unsigned slab_size_ = 1 << 16;
+  static const unsigned max_pooled_size_ = 256;
+
+  std::vector<T *> slabs_;
+  // the number of elements of slabs_.back() handed out
+  unsigned slab_used_ = slab_size_;
+
+  // free_lists_[s] contains freed arrays of size s
+  std::vector<std::vector<T *>> free_lists_;
+  uint64_t num_free_elements_ = 0;
+};
+} // sharpSAT namespace
+#endif /* SLAB_ALLOCATOR_H_ */
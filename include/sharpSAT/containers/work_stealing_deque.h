@@ -0,0 +1,60 @@
+/*
+ * work_stealing_deque.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef SHARP_SAT_WORK_STEALING_DEQUE_H_
+#define SHARP_SAT_WORK_STEALING_DEQUE_H_
+
+#include <deque>
+#include <mutex>
+#include <utility>
+
+namespace sharpSAT {
+
+/*!
+ * Task queue owned by a single worker thread.
+ *
+ * The owner pushes and pops at the back (LIFO, the most recently
+ * dispatched task is still warm in its caches), other workers
+ * steal from the front (FIFO, the oldest tasks tend to be the largest).
+ *
+ * Component tasks are coarse grained, hence a short critical section
+ * per operation is cheap enough that a lock-free deque does not pay off.
+ */
+template <class T>
+class WorkStealingDeque {
+public:
+
+  void push(T &&item) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    items_.push_back(std::move(item));
+  }
+
+  //! Called by the owner only.
+  bool pop(T &item) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (items_.empty())
+      return false;
+    item = std::move(items_.back());
+    items_.pop_back();
+    return true;
+  }
+
+  //! Called by any thread but the owner.
+  bool steal(T &item) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (items_.empty())
+      return false;
+    item = std::move(items_.front());
+    items_.pop_front();
+    return true;
+  }
+
+private:
+  std::mutex mutex_;
+  std::deque<T> items_;
+}; // WorkStealingDeque
+} // sharpSAT namespace
+#endif /* WORK_STEALING_DEQUE_H_ */
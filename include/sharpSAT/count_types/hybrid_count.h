@@ -0,0 +1,164 @@
+/*
+ * hybrid_count.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef SHARP_SAT_HYBRID_COUNT_H_
+#define SHARP_SAT_HYBRID_COUNT_H_
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <gmpxx.h>
+
+namespace sharpSAT {
+
+/*!
+ * Non-negative model count.
+ *
+ * Most component counts fit into 128 bits, these are computed with native
+ * arithmetic. Only a count overflowing 128 bits is promoted to an
+ * mpz_class, which then is kept on the heap.
+ */
+class HybridCount {
+public:
+  HybridCount() {}
+
+  HybridCount(uint64_t value) : lo_(value) {}
+
+  // literal weights have to be non-negative integers below 2^64
+  static bool from_weight(long double weight, HybridCount &count) {
+    if (!(weight >= 0 && weight < 18446744073709551616.0L
+        && weight == std::floor(weight)))
+      return false;
+    count = HybridCount(static_cast<uint64_t>(weight));
+    return true;
+  }
+
+  HybridCount(const HybridCount &other) :
+      lo_(other.lo_), hi_(other.hi_),
+      big_(other.big_ ? new mpz_class(*other.big_) : nullptr) {
+  }
+
+  HybridCount(HybridCount &&other) noexcept :
+      lo_(other.lo_), hi_(other.hi_), big_(other.big_) {
+    other.big_ = nullptr;
+  }
+
+  ~HybridCount() {
+    delete big_;
+  }
+
+  HybridCount &operator=(const HybridCount &other) {
+    if (other.big_) {
+      if (big_)
+        *big_ = *other.big_;
+      else
+        big_ = new mpz_class(*other.big_);
+    } else {
+      delete big_;
+      big_ = nullptr;
+      lo_ = other.lo_;
+      hi_ = other.hi_;
+    }
+    return *this;
+  }
+
+  HybridCount &operator=(HybridCount &&other) noexcept {
+    std::swap(lo_, other.lo_);
+    std::swap(hi_, other.hi_);
+    std::swap(big_, other.big_);
+    return *this;
+  }
+
+  bool operator==(uint64_t value) const {
+    if (big_)
+      return *big_ == static_cast<unsigned long>(value);
+    return hi_ == 0 && lo_ == value;
+  }
+
+  bool operator!=(uint64_t value) const {
+    return !(*this == value);
+  }
+
+  HybridCount &operator*=(const HybridCount &other) {
+    uint128 product;
+    if (!big_ && !other.big_
+        && !__builtin_mul_overflow(native(), other.native(), &product)) {
+      set_native(product);
+      return *this;
+    }
+    multiplyBig(other);
+    return *this;
+  }
+
+  HybridCount &operator+=(const HybridCount &other) {
+    uint128 sum;
+    if (!big_ && !other.big_
+        && !__builtin_add_overflow(native(), other.native(), &sum)) {
+      set_native(sum);
+      return *this;
+    }
+    addBig(other);
+    return *this;
+  }
+
+  friend HybridCount operator+(HybridCount lhs, const HybridCount &rhs) {
+    lhs += rhs;
+    return lhs;
+  }
+
+  // multiplies the count by 2^exponent
+  void mul_2exp(unsigned long exponent);
+
+  mpz_class get_mpz() const;
+
+  std::string get_str() const {
+    return get_mpz().get_str();
+  }
+
+  // the count as little endian bytes, for files
+  std::string to_bytes() const;
+
+  // returns false if bytes were not written by to_bytes()
+  static bool from_bytes(const std::string &bytes, HybridCount &count);
+
+  // returns false if str is not a count written by get_str()
+  static bool from_str(const std::string &str, HybridCount &count);
+
+  // the number of bytes allocated on the heap, 0 unless promoted
+  size_t heap_byte_size() const {
+    if (!big_)
+      return 0;
+    return sizeof(mpz_class)
+        + big_->get_mpz_t()->_mp_alloc * sizeof(mp_limb_t);
+  }
+
+private:
+  typedef unsigned __int128 uint128;
+
+  uint128 native() const {
+    return (static_cast<uint128>(hi_) << 64) | lo_;
+  }
+
+  void set_native(uint128 value) {
+    lo_ = static_cast<uint64_t>(value);
+    hi_ = static_cast<uint64_t>(value >> 64);
+  }
+
+  // stores the count in big_ if it is not there yet
+  void promote();
+
+  void multiplyBig(const HybridCount &other);
+  void addBig(const HybridCount &other);
+
+  // the native value, both are unused once big_ is set
+  uint64_t lo_ = 0;
+  uint64_t hi_ = 0;
+  mpz_class *big_ = nullptr;
+};
+} // sharpSAT namespace
+#endif /* HYBRID_COUNT_H_ */
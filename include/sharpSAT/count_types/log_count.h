@@ -0,0 +1,150 @@
+/*
+ * log_count.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef SHARP_SAT_LOG_COUNT_H_
+#define SHARP_SAT_LOG_COUNT_H_
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <string>
+
+namespace sharpSAT {
+
+/*!
+ * Approximate model count, kept as the binary logarithm of the count.
+ *
+ * Products become sums, hence counts far beyond the range of a
+ * long double are fine. A count of 0 is stored as -infinity.
+ */
+class LogCount {
+public:
+  LogCount() {}
+
+  LogCount(uint64_t value) :
+      log2_(value ? std::log2(static_cast<long double>(value)) : zero_) {
+  }
+
+  // literal weights have to be non-negative
+  static bool from_weight(long double weight, LogCount &count) {
+    if (!(weight >= 0 && std::isfinite(weight)))
+      return false;
+    count.log2_ = weight > 0 ? std::log2(weight) : zero_;
+    return true;
+  }
+
+  bool operator==(uint64_t value) const {
+    return log2_ == LogCount(value).log2_;
+  }
+
+  bool operator!=(uint64_t value) const {
+    return !(*this == value);
+  }
+
+  LogCount &operator*=(const LogCount &other) {
+    if (log2_ != zero_ && other.log2_ != zero_)
+      log2_ += other.log2_;
+    else
+      log2_ = zero_;
+    return *this;
+  }
+
+  LogCount &operator+=(const LogCount &other) {
+    long double lo = std::fmin(log2_, other.log2_);
+    long double hi = std::fmax(log2_, other.log2_);
+    if (lo != zero_)
+      hi += std::log2(1 + std::exp2(lo - hi));
+    log2_ = hi;
+    return *this;
+  }
+
+  friend LogCount operator+(LogCount lhs, const LogCount &rhs) {
+    lhs += rhs;
+    return lhs;
+  }
+
+  // multiplies the count by 2^exponent
+  void mul_2exp(unsigned long exponent) {
+    if (log2_ != zero_)
+      log2_ += exponent;
+  }
+
+  long double log2() const {
+    return log2_;
+  }
+
+  // the count in scientific notation, e.g. 1.2676506e+30
+  std::string get_str() const {
+    if (log2_ == zero_)
+      return "0";
+    long double log10 = log2_ * std::log10(2.0L);
+    long double exponent = std::floor(log10);
+    long double mantissa = std::pow(10.0L, log10 - exponent);
+    // do not print 10e+n, if the mantissa is rounded up
+    if (mantissa >= 9.99999995L) {
+      mantissa = 1;
+      exponent++;
+    }
+    std::ostringstream out;
+    out.precision(8);
+    out << mantissa << "e+"
+        << static_cast<uint64_t>(exponent);
+    return out.str();
+  }
+
+  // the logarithm in native byte order, for files
+  std::string to_bytes() const {
+    return std::string(reinterpret_cast<const char *>(&log2_),
+        sizeof(log2_));
+  }
+
+  // returns false if bytes were not written by to_bytes()
+  static bool from_bytes(const std::string &bytes, LogCount &count) {
+    if (bytes.size() != sizeof(count.log2_))
+      return false;
+    std::memcpy(&count.log2_, bytes.data(), sizeof(count.log2_));
+    return true;
+  }
+
+  // returns false if str is not a count written by get_str(),
+  // whose exponent may exceed the range of long double
+  static bool from_str(const std::string &str, LogCount &count) {
+    if (str == "0") {
+      count.log2_ = zero_;
+      return true;
+    }
+    size_t e = str.find('e');
+    if (e == std::string::npos)
+      return false;
+    std::string mantissa_str = str.substr(0, e);
+    const char *exponent_str = str.c_str() + e + 1;
+    char *end;
+    long double mantissa = std::strtold(mantissa_str.c_str(), &end);
+    if (*end != '\0' || !(mantissa > 0))
+      return false;
+    long double exponent = std::strtold(exponent_str, &end);
+    if (end == exponent_str || *end != '\0')
+      return false;
+    count.log2_ = std::log2(mantissa) + exponent * std::log2(10.0L);
+    return true;
+  }
+
+  size_t heap_byte_size() const {
+    return 0;
+  }
+
+private:
+  static constexpr long double zero_ =
+      -std::numeric_limits<long double>::infinity();
+
+  long double log2_ = zero_;
+};
+} // sharpSAT namespace
+#endif /* LOG_COUNT_H_ */
@@ -0,0 +1,46 @@
+/*
+ * model_count.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef SHARP_SAT_MODEL_COUNT_H_
+#define SHARP_SAT_MODEL_COUNT_H_
+
+#include <sharpSAT/count_types/hybrid_count.h>
+#include <sharpSAT/count_types/log_count.h>
+#include <sharpSAT/count_types/modular_count.h>
+#include <sharpSAT/count_types/weighted_count.h>
+
+namespace sharpSAT {
+
+// ModelCount is the type of all model counts of the solver, chosen at
+// compile time by the CMake option SHARPSAT_COUNT_TYPE.
+//
+// Any replacement has to be constructible from uint64_t, with the default
+// value being 0, and to provide +=, *=, +, == and != for uint64_t values,
+// mul_2exp(), get_str(), heap_byte_size(), from_weight(), to_bytes(),
+// from_bytes() and from_str() as HybridCount does.
+//
+// MODEL_COUNT_TYPE names the choice in files written by the solver.
+
+#define SHARPSAT_STRINGIFY_(x) #x
+#define SHARPSAT_STRINGIFY(x) SHARPSAT_STRINGIFY_(x)
+
+#if defined(SHARPSAT_COUNT_TYPE_MODULAR)
+typedef ModularCount ModelCount;
+constexpr const char *MODEL_COUNT_TYPE =
+    "MODULAR " SHARPSAT_STRINGIFY(SHARPSAT_COUNT_MODULUS);
+#elif defined(SHARPSAT_COUNT_TYPE_LOG)
+typedef LogCount ModelCount;
+constexpr const char *MODEL_COUNT_TYPE = "LOG";
+#elif defined(SHARPSAT_COUNT_TYPE_WEIGHTED)
+typedef WeightedCount ModelCount;
+constexpr const char *MODEL_COUNT_TYPE = "WEIGHTED";
+#else
+typedef HybridCount ModelCount;
+constexpr const char *MODEL_COUNT_TYPE = "EXACT";
+#endif
+
+} // sharpSAT namespace
+#endif /* MODEL_COUNT_H_ */
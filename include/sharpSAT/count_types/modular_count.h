@@ -0,0 +1,132 @@
+/*
+ * modular_count.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef SHARP_SAT_MODULAR_COUNT_H_
+#define SHARP_SAT_MODULAR_COUNT_H_
+
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+// a prime below 2^63, such that sums of two residues do not overflow
+#ifndef SHARPSAT_COUNT_MODULUS
+#define SHARPSAT_COUNT_MODULUS 2305843009213693951ull // 2^61 - 1
+#endif
+
+namespace sharpSAT {
+
+/*!
+ * Model count modulo the prime SHARPSAT_COUNT_MODULUS.
+ *
+ * A residue of 0 marks a branch as unsatisfiable. This is also right for
+ * a satisfiable branch whose count is a multiple of the modulus, as the
+ * count of every branch containing it is a multiple as well.
+ */
+class ModularCount {
+public:
+  ModularCount() {}
+
+  ModularCount(uint64_t value) : value_(value % modulus_) {}
+
+  // literal weights have to be non-negative integers below 2^64
+  static bool from_weight(long double weight, ModularCount &count) {
+    if (!(weight >= 0 && weight < 18446744073709551616.0L
+        && weight == std::floor(weight)))
+      return false;
+    count = ModularCount(static_cast<uint64_t>(weight));
+    return true;
+  }
+
+  bool operator==(uint64_t value) const {
+    return value_ == value % modulus_;
+  }
+
+  bool operator!=(uint64_t value) const {
+    return !(*this == value);
+  }
+
+  ModularCount &operator*=(const ModularCount &other) {
+    value_ = static_cast<uint64_t>(
+        static_cast<unsigned __int128>(value_) * other.value_ % modulus_);
+    return *this;
+  }
+
+  ModularCount &operator+=(const ModularCount &other) {
+    value_ += other.value_;
+    if (value_ >= modulus_)
+      value_ -= modulus_;
+    return *this;
+  }
+
+  friend ModularCount operator+(ModularCount lhs, const ModularCount &rhs) {
+    lhs += rhs;
+    return lhs;
+  }
+
+  // multiplies the count by 2^exponent
+  void mul_2exp(unsigned long exponent) {
+    ModularCount power(2);
+    for (; exponent; exponent >>= 1) {
+      if (exponent & 1)
+        *this *= power;
+      power *= power;
+    }
+  }
+
+  uint64_t residue() const {
+    return value_;
+  }
+
+  std::string get_str() const {
+    return std::to_string(value_);
+  }
+
+  // the residue in native byte order, for files
+  std::string to_bytes() const {
+    return std::string(reinterpret_cast<const char *>(&value_),
+        sizeof(value_));
+  }
+
+  // returns false if bytes were not written by to_bytes()
+  static bool from_bytes(const std::string &bytes, ModularCount &count) {
+    uint64_t value;
+    if (bytes.size() != sizeof(value))
+      return false;
+    std::memcpy(&value, bytes.data(), sizeof(value));
+    if (value >= modulus_)
+      return false;
+    count.value_ = value;
+    return true;
+  }
+
+  // returns false if str is not a residue written by get_str()
+  static bool from_str(const std::string &str, ModularCount &count) {
+    char *end;
+    errno = 0;
+    unsigned long long value = std::strtoull(str.c_str(), &end, 10);
+    if (str.empty() || !std::isdigit(static_cast<unsigned char>(str[0]))
+        || *end != '\0' || errno == ERANGE || value >= modulus_)
+      return false;
+    count.value_ = value;
+    return true;
+  }
+
+  size_t heap_byte_size() const {
+    return 0;
+  }
+
+private:
+  static const uint64_t modulus_ = SHARPSAT_COUNT_MODULUS;
+
+  uint64_t value_ = 0;
+};
+} // sharpSAT namespace
+#endif /* MODULAR_COUNT_H_ */
@@ -0,0 +1,113 @@
+/*
+ * weighted_count.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef SHARP_SAT_WEIGHTED_COUNT_H_
+#define SHARP_SAT_WEIGHTED_COUNT_H_
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <string>
+
+namespace sharpSAT {
+
+/*!
+ * Real valued model count, as needed when models are weighted by the
+ * product of the weights of their literals.
+ *
+ * Kept in a long double, i.e. it is exact for integer counts up to 2^64
+ * and rounded beyond.
+ */
+class WeightedCount {
+public:
+  WeightedCount() {}
+
+  WeightedCount(uint64_t value) : value_(value) {}
+
+  // any finite literal weight is fine
+  static bool from_weight(long double weight, WeightedCount &count) {
+    if (!std::isfinite(weight))
+      return false;
+    count.value_ = weight;
+    return true;
+  }
+
+  bool operator==(uint64_t value) const {
+    return value_ == value;
+  }
+
+  bool operator!=(uint64_t value) const {
+    return !(*this == value);
+  }
+
+  WeightedCount &operator*=(const WeightedCount &other) {
+    value_ *= other.value_;
+    return *this;
+  }
+
+  WeightedCount &operator+=(const WeightedCount &other) {
+    value_ += other.value_;
+    return *this;
+  }
+
+  friend WeightedCount operator+(WeightedCount lhs, const WeightedCount &rhs) {
+    lhs += rhs;
+    return lhs;
+  }
+
+  // multiplies the count by 2^exponent
+  void mul_2exp(unsigned long exponent) {
+    value_ = std::ldexp(value_, static_cast<int>(exponent));
+  }
+
+  long double value() const {
+    return value_;
+  }
+
+  std::string get_str() const {
+    std::ostringstream out;
+    out.precision(std::numeric_limits<long double>::digits10);
+    out << value_;
+    return out.str();
+  }
+
+  // the value in native byte order, for files
+  std::string to_bytes() const {
+    return std::string(reinterpret_cast<const char *>(&value_),
+        sizeof(value_));
+  }
+
+  // returns false if bytes were not written by to_bytes()
+  static bool from_bytes(const std::string &bytes, WeightedCount &count) {
+    if (bytes.size() != sizeof(count.value_))
+      return false;
+    std::memcpy(&count.value_, bytes.data(), sizeof(count.value_));
+    return true;
+  }
+
+  // returns false if str is not a value written by get_str()
+  static bool from_str(const std::string &str, WeightedCount &count) {
+    char *end;
+    long double value = std::strtold(str.c_str(), &end);
+    if (str.empty() || *end != '\0' || !std::isfinite(value))
+      return false;
+    count.value_ = value;
+    return true;
+  }
+
+  size_t heap_byte_size() const {
+    return 0;
+  }
+
+private:
+  long double value_ = 0;
+};
+} // sharpSAT namespace
+#endif /* WEIGHTED_COUNT_H_ */
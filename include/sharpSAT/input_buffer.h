@@ -0,0 +1,131 @@
+/*
+ * input_buffer.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef SHARP_SAT_INPUT_BUFFER_H_
+#define SHARP_SAT_INPUT_BUFFER_H_
+
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sharpSAT {
+
+class Decompressor;
+
+/*!
+ * The contents of an input file, together with the scanning primitives
+ * of the DIMACS parser.
+ *
+ * Plain files are mapped into memory where possible. Files compressed
+ * with gzip, xz or zstd are decompressed chunk by chunk while scanning,
+ * as far as the build supports the format.
+ */
+class InputBuffer {
+public:
+  InputBuffer();
+  ~InputBuffer();
+
+  InputBuffer(const InputBuffer &) = delete;
+  InputBuffer &operator=(const InputBuffer &) = delete;
+
+  // returns false, if the file cannot be read
+  bool open(const std::string &file_name);
+
+  // the size of the file, compressed or not
+  size_t size() const {
+    return file_size_;
+  }
+
+  // skips white space, line breaks included, and returns the next
+  // character without consuming it, or 0 at the end of the input
+  char peekNonSpace() {
+    do {
+      while (pos_ != end_ && isSpace(*pos_))
+        pos_++;
+    } while (pos_ == end_ && refill());
+    return pos_ != end_ ? *pos_ : 0;
+  }
+
+  void skipChar() {
+    if (pos_ != end_)
+      pos_++;
+  }
+
+  // reads a decimal integer following white space,
+  // returns false, if there is none or it does not fit into an int
+  bool readInt(int &value) {
+    peekNonSpace();
+    bool negative = pos_ != end_ && *pos_ == '-';
+    if (negative && ++pos_ == end_)
+      refill();
+    if (pos_ == end_ || !isDigit(*pos_))
+      return false;
+    unsigned long long result = 0;
+    do {
+      result = result * 10 + static_cast<unsigned>(*pos_ - '0');
+      if (result > INT_MAX)
+        return false;
+      pos_++;
+    } while ((pos_ != end_ || refill()) && isDigit(*pos_));
+    value = negative ? -static_cast<int>(result) : static_cast<int>(result);
+    return true;
+  }
+
+  // consumes the rest of the current line and the line break
+  void skipLine() {
+    while (pos_ != end_ || refill()) {
+      auto line_end = static_cast<const char *>(
+          memchr(pos_, '\n', static_cast<size_t>(end_ - pos_)));
+      if (line_end) {
+        pos_ = line_end + 1;
+        return;
+      }
+      pos_ = end_;
+    }
+  }
+
+  // consumes the rest of the current line and returns it
+  // without the line break
+  std::string readLine();
+
+  // copies the next size bytes to data,
+  // returns false if the input ends before
+  bool readBytes(void *data, size_t size);
+
+private:
+  const char *pos_ = nullptr;
+  const char *end_ = nullptr;
+
+  size_t file_size_ = 0;
+
+  void *mapping_ = nullptr;
+  size_t mapping_size_ = 0;
+
+  // the file contents, if the file could not be mapped,
+  // or the current chunk of a compressed file
+  std::vector<char> data_;
+
+  // null, unless the file is compressed
+  std::unique_ptr<Decompressor> decompressor_;
+
+  // replaces the consumed buffer by the next chunk of a compressed file,
+  // returns false at the end of the input
+  bool refill();
+
+  static bool isSpace(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+  }
+
+  static bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+  }
+};
+
+} // sharpSAT namespace
+#endif /* INPUT_BUFFER_H_ */
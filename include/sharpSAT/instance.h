@@ -13,9 +13,13 @@
 #include <sharpSAT/containers.h>
 
 #include <assert.h>
+#include <utility>
 
 namespace sharpSAT {
 
+class BinaryReader;
+class BinaryWriter;
+
 class Instance {
 public:
 
@@ -49,6 +53,32 @@ public:
    */
   void finalize(unsigned int nVars, unsigned int nCls);
 
+  /**
+   * Sets the weight of a literal, which is 1 unless set otherwise.
+   *
+   * If any weight is set, each model counts with the product of the
+   * weights of its literals. Must be called after \ref initialize().
+   *
+   * @returns `false` if the weight cannot be represented by \ref ModelCount
+   */
+  bool set_literal_weight(LiteralID lit, long double weight);
+
+  bool weighted() const {
+    return !literal_weights_.empty();
+  }
+
+  /**
+   * Restricts the count to the given projection variables, i.e. counts
+   * the assignments to them that extend to a model. An empty projection
+   * counts 1 for a satisfiable formula. Must be called after
+   * \ref initialize().
+   */
+  void set_projection(const std::vector<VariableIndex> &vars);
+
+  bool projected() const {
+    return !projection_.empty();
+  }
+
 protected:
 
   void unSet(LiteralID lit) {
@@ -96,7 +126,9 @@ protected:
   // removes all set variables and essentially reinitiallizes all
   // further data
   void compactClauses();
-  void compactVariables();
+  // keep_free_variables keeps the variables which occur in no clause
+  // anymore, so that they can still be assumed by compactedLiterals()
+  void compactVariables(bool keep_free_variables = false);
   void cleanClause(ClauseOfs cl_ofs);
 
   /////////////////////////////////////////////////////////
@@ -114,6 +146,54 @@ protected:
 
   bool createfromFile(const std::string &file_name);
 
+  /**
+   * Saves the formula to a binary snapshot file, which is loaded much
+   * faster than the input file. Meant to be called after preprocessing.
+   *
+   * @param[in] input_file the file the formula has been read from
+   * @param[in] options how the formula has been preprocessed
+   * @returns `false` if the snapshot could not be written
+   */
+  bool writeSnapshot(const std::string &snapshot_file,
+                     const std::string &input_file,
+                     const std::string &options);
+
+  /**
+   * Replaces the formula by the one saved by \ref writeSnapshot().
+   *
+   * @returns `false` if the file is missing or has been written for
+   *   another input file, options or build, the formula is unchanged then
+   */
+  bool readSnapshot(const std::string &snapshot_file,
+                    const std::string &input_file,
+                    const std::string &options);
+
+  /*!
+   * Translates literals of the input formula into literals of the formula
+   * compacted by `compactVariables(true)`. Literals which preprocessing
+   * has already made true are left out.
+   *
+   * \returns `false` if preprocessing has made one of the literals false
+   */
+  bool compactedLiterals(const std::vector<LiteralID> &lits,
+                         std::vector<LiteralID> &compacted) const;
+
+  // saveClauses() stores the clauses, restoreClauses() puts them back,
+  // which drops all conflict clauses learned in between
+  void saveClauses();
+  void restoreClauses();
+
+  // the clauses, learned ones included, and the assignment of a search,
+  // which a checkpoint saves along with the solver's stacks.
+  // readSearchState() expects the formula the search started on, and
+  // returns false if the file is corrupt.
+  void writeSearchState(BinaryWriter &out);
+  bool readSearchState(BinaryReader &in);
+
+  // a hash of the preprocessed formula, which tells whether files written
+  // for another formula, like cached model counts, apply to this one
+  uint64_t fingerprint();
+
   DataAndStatistics statistics_;
 
   /**
@@ -162,6 +242,42 @@ protected:
    */
   LiteralIndexedVector<TriValue> literal_values_;
 
+  /*!
+   * Weights of the literals, indexed by \ref LiteralID.
+   *
+   * Empty unless the formula is weighted.
+   */
+  LiteralIndexedVector<ModelCount> literal_weights_;
+
+  /*!
+   * projection_[v] is true iff v is a projection variable.
+   *
+   * Empty unless the count is projected.
+   */
+  VariableIndexedVector<bool> projection_;
+
+  //! Factor of the count due to the variables removed by compactVariables().
+  ModelCount removed_variables_weight_ = 1;
+
+  /*!
+   * The variable of the compacted formula for each variable of the input
+   * formula, VariableIndex(0) for the variables compactVariables() has
+   * removed, whose values input_literal_values_ holds.
+   *
+   * Empty unless compactVariables() kept the free variables.
+   */
+  VariableIndexedVector<VariableIndex> compacted_variables_;
+  LiteralIndexedVector<TriValue> input_literal_values_;
+
+  std::vector<LiteralID> saved_literal_pool_;
+  LiteralIndexedVector<Literal> saved_literals_;
+  std::vector<LiteralID> saved_unit_clauses_;
+
+  // variables outside the projection do not multiply the count
+  bool inProjection(VariableIndex v) const {
+    return projection_.empty() || projection_[v];
+  }
+
   void decayActivities() {
     for (auto l_it = literals_.begin(); l_it != literals_.end(); l_it++)
       l_it->activity_score_ *= 0.5;
@@ -338,6 +454,9 @@ Antecedent Instance::addUIPConflictClause(std::vector<LiteralID> &literals) {
   }
 
 bool Instance::addBinaryClause(LiteralID litA, LiteralID litB) {
+   // links are symmetric, so the shorter list suffices
+   if (literal(litA).binary_links_.size() > literal(litB).binary_links_.size())
+     std::swap(litA, litB);
    if (literal(litA).hasBinaryLinkTo(litB))
      return false;
    literal(litA).addBinLinkTo(litB);
@@ -0,0 +1,111 @@
+/*
+ * marginal_stack.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef SHARP_SAT_MARGINAL_STACK_H_
+#define SHARP_SAT_MARGINAL_STACK_H_
+
+#include <sharpSAT/containers.h>
+#include <sharpSAT/component_types/component.h>
+#include <sharpSAT/count_types/model_count.h>
+
+#include <vector>
+
+namespace sharpSAT {
+
+/*!
+ * The marginal counts of the super components of the decision stack,
+ * i.e. for each of their variables the model counts with either literal
+ * true. Marginals are laid out two per variable of a component, in the
+ * order of its variables: first that of the negative literal, then that
+ * of the positive one.
+ *
+ * Each level of the decision stack has a level here. The marginals of
+ * the components a branch splits into are collected in the level, and
+ * \ref finishBranch() combines them into those of the super component:
+ * the marginal of a literal in one component is multiplied by the
+ * counts of all others, a literal the branch has set true gets the
+ * count of the whole branch. Both branches add up, as the counts do.
+ */
+class MarginalStack {
+public:
+  explicit MarginalStack(unsigned max_variable_id) :
+      position_(max_variable_id + 1) {
+    push();
+  }
+
+  void push() {
+    if (depth_ == levels_.size())
+      levels_.emplace_back();
+    else
+      levels_[depth_].clear();
+    depth_++;
+  }
+
+  void pop() {
+    depth_--;
+  }
+
+  // comp of count model_count, with marginals, is part of the active
+  // branch of the top level
+  void includeComponent(const ModelCount &model_count, const Component &comp,
+      const std::vector<ModelCount> &marginals);
+
+  // the active branch of the top level has no models
+  void discardBranch() {
+    levels_[depth_ - 1].clearParts();
+  }
+
+  // adds the marginals of the active branch of the top level, in which
+  // super_comp has branch_count models, to the marginals of super_comp.
+  // The variables of super_comp unassigned and in no component included
+  // are free.
+  void finishBranch(const Component &super_comp, const ModelCount &branch_count,
+      const LiteralIndexedVector<TriValue> &literal_values,
+      const LiteralIndexedVector<ModelCount> &literal_weights);
+
+  // the marginals of the super component of the top level,
+  // once a branch has been finished
+  const std::vector<ModelCount> &marginals() const {
+    return levels_[depth_ - 1].marginals;
+  }
+
+private:
+  struct Level {
+    // the counts of the components of the active branch,
+    // the variables of component i end at vars[ends[i]]
+    std::vector<ModelCount> counts;
+    std::vector<unsigned> ends;
+    std::vector<VariableIndex> vars;
+    std::vector<ModelCount> part_marginals;
+
+    // the marginals of the super component summed over the branches
+    std::vector<ModelCount> marginals;
+
+    void clearParts() {
+      counts.clear();
+      ends.clear();
+      vars.clear();
+      part_marginals.clear();
+    }
+
+    void clear() {
+      clearParts();
+      marginals.clear();
+    }
+  };
+
+  // the levels beyond depth_ are kept for their capacity
+  std::vector<Level> levels_;
+  unsigned depth_ = 0;
+
+  // the position of each variable in the super component of finishBranch()
+  VariableIndexedVector<unsigned> position_;
+  std::vector<bool> in_component_;
+  std::vector<ModelCount> suffix_counts_;
+};
+
+} // sharpSAT namespace
+#endif /* MARGINAL_STACK_H_ */
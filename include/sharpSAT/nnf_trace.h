@@ -0,0 +1,113 @@
+/*
+ * nnf_trace.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef SHARP_SAT_NNF_TRACE_H_
+#define SHARP_SAT_NNF_TRACE_H_
+
+#include <sharpSAT/containers.h>
+#include <sharpSAT/component_types/component.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace sharpSAT {
+
+/*!
+ * Writes the search as a decision-DNNF in the NNF format of c2d.
+ *
+ * Each decision level becomes a decision node over the two branches,
+ * each branch an AND node of the literals it sets and of the nodes of the
+ * components it splits into. Nodes are written as soon as they are
+ * complete, to a temporary file, which \ref close() prefixes with the
+ * header once the root node is known.
+ *
+ * Literals are those of the formula as loaded: the variables of the
+ * formula searched are mapped by input_variables.
+ */
+class NnfTrace {
+public:
+  // returns false if file_name cannot be written
+  bool open(const std::string &file_name, unsigned num_input_variables,
+      const VariableIndexedVector<VariableIndex> &input_variables);
+
+  // writes the file with root as its root node,
+  // returns false if it could not be written
+  bool close(unsigned root);
+
+  // removes the temporary file, e.g. after a timeout
+  void discard();
+
+  void push() {
+    levels_.push_back(Level{static_cast<unsigned>(children_.size())});
+  }
+
+  // node is a child of the AND node of the active branch of the top level
+  void includeNode(unsigned node) {
+    children_.push_back(node);
+  }
+
+  void includeLiteral(LiteralID input_lit) {
+    includeNode(literalNode(input_lit));
+  }
+
+  // the active branch of the top level has no models
+  void discardBranch() {
+    children_.resize(levels_.back().children_ofs);
+  }
+
+  // writes the AND node of the active branch of the top level, of the
+  // literals of super_comp set in the branch and of the nodes included,
+  // or takes the false node if found_unsat
+  void finishBranch(const Component &super_comp, bool active_branch,
+      bool found_unsat, const LiteralIndexedVector<TriValue> &literal_values);
+
+  // pops the top level and returns its node, the decision node on
+  // decision_var over both branches
+  unsigned pop(VariableIndex decision_var);
+
+  // the node of the only branch of a level without decision
+  unsigned rootNode() const {
+    return levels_.back().branch_nodes[1];
+  }
+
+  static const unsigned FALSE_NODE = 0;
+  static const unsigned TRUE_NODE = 1;
+
+private:
+  struct Level {
+    // the children of the active branch are children_[children_ofs..]
+    unsigned children_ofs;
+    unsigned branch_nodes[2] = {FALSE_NODE, FALSE_NODE};
+  };
+
+  unsigned literalNode(LiteralID input_lit);
+
+  unsigned writeNode(const std::string &line, unsigned num_edges) {
+    out_ << line << '\n';
+    num_edges_ += num_edges;
+    return num_nodes_++;
+  }
+
+  std::string file_name_;
+  std::string tmp_file_name_;
+  std::ofstream out_;
+
+  unsigned num_nodes_ = 0;
+  unsigned long num_edges_ = 0;
+  unsigned num_input_variables_ = 0;
+
+  // empty if the variables are those of the formula as loaded
+  VariableIndexedVector<VariableIndex> input_variables_;
+  // 0 for the literals without node yet
+  LiteralIndexedVector<unsigned> literal_nodes_;
+
+  std::vector<Level> levels_;
+  std::vector<unsigned> children_;
+};
+
+} // sharpSAT namespace
+#endif /* NNF_TRACE_H_ */
@@ -0,0 +1,156 @@
+/*
+ * parallel_counter.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef SHARP_SAT_PARALLEL_COUNTER_H_
+#define SHARP_SAT_PARALLEL_COUNTER_H_
+
+#include <sharpSAT/instance.h>
+#include <sharpSAT/solver_config.h>
+#include <sharpSAT/count_types/model_count.h>
+#include <sharpSAT/shared_component_cache.h>
+#include <sharpSAT/containers/work_stealing_deque.h>
+#include <sharpSAT/component_types/component.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sharpSAT {
+
+/*!
+ * Model counts of the components dispatched from one \ref StackLevel.
+ *
+ * The dispatching solver waits for the batch before it leaves
+ * the branch in which the components were found.
+ */
+class ComponentBatch {
+public:
+  explicit ComponentBatch(unsigned size):
+      counts_(size), num_pending_(size) {
+  }
+
+  //! Called by a worker once the component in `slot` is done.
+  void deliver(unsigned slot, bool counted, const ModelCount &count);
+
+  /*!
+   * Waits at most `milliseconds` for the outstanding components.
+   *
+   * \returns `true` if no component is outstanding anymore
+   */
+  bool waitFor(unsigned milliseconds);
+
+  //! Workers stop counting the components of a cancelled batch.
+  void cancel() {
+    cancelled_ = true;
+  }
+
+  const std::atomic<bool> &cancelled() const {
+    return cancelled_;
+  }
+
+  //! `false` if some component has not been counted (e.g. cancellation)
+  bool succeeded() const {
+    return !failed_;
+  }
+
+  //! `true` as soon as some component has been found to have no model
+  bool found_unsat() const {
+    return found_unsat_.load(std::memory_order_relaxed);
+  }
+
+  const ModelCount &count(unsigned slot) const {
+    return counts_[slot];
+  }
+
+private:
+  std::mutex mutex_;
+  std::condition_variable all_delivered_;
+
+  std::vector<ModelCount> counts_;
+  unsigned num_pending_;
+  bool failed_ = false;
+
+  std::atomic<bool> cancelled_{false};
+  std::atomic<bool> found_unsat_{false};
+}; // ComponentBatch
+
+/*!
+ * A component to be counted by a worker.
+ *
+ * The component is given in terms of the variable and clause indices
+ * of the dispatching solver, together with the assignment under which
+ * it has been found.
+ */
+struct ComponentTask {
+  std::shared_ptr<ComponentBatch> batch;
+  unsigned slot = 0;
+  std::shared_ptr<const std::vector<LiteralID>> assignment;
+  Component component;
+};
+
+/*!
+ * Pool of worker threads counting independent components.
+ *
+ * Each worker owns a \ref WorkStealingDeque; dispatched components
+ * are spread over the deques and idle workers steal from the others.
+ * A worker counts a component with a fresh \ref Solver built from
+ * the preprocessed formula, which assigns the dispatching solver's
+ * literals at decision level 0 and restricts the search to the component.
+ * The workers reuse each other's model counts via a \ref SharedComponentCache.
+ */
+class ParallelComponentCounter {
+public:
+  /*!
+   * \param[in] formula preprocessed formula without learned clauses
+   * \param[in] config configuration of the dispatching solver
+   * \param[in] cache_bytes cache size bound of each worker's solver
+   * \param[in] shared_cache cache used by all workers,
+   *   it has to outlive the counter
+   */
+  ParallelComponentCounter(const Instance &formula,
+      const SolverConfiguration &config, uint64_t cache_bytes,
+      SharedComponentCache &shared_cache);
+
+  ~ParallelComponentCounter();
+
+  ParallelComponentCounter(const ParallelComponentCounter&) = delete;
+  ParallelComponentCounter &operator=(const ParallelComponentCounter&) = delete;
+
+  std::shared_ptr<ComponentBatch> dispatch(
+      const std::vector<LiteralID> &assignment,
+      std::vector<Component> &&components);
+
+  unsigned num_workers() const {
+    return workers_.size();
+  }
+
+private:
+  void work(unsigned worker_id);
+  bool fetchTask(unsigned worker_id, ComponentTask &task);
+  void count(ComponentTask &task);
+
+  const Instance formula_;
+  SolverConfiguration config_;
+  uint64_t cache_bytes_;
+  SharedComponentCache &shared_cache_;
+
+  std::vector<std::unique_ptr<WorkStealingDeque<ComponentTask>>> deques_;
+  std::vector<std::thread> workers_;
+
+  // guards sleeping and waking up of idle workers
+  std::mutex mutex_;
+  std::condition_variable work_available_;
+  std::atomic<unsigned> num_queued_{0};
+  bool shutdown_ = false;
+
+  unsigned next_deque_ = 0;
+}; // ParallelComponentCounter
+} // sharpSAT namespace
+#endif /* PARALLEL_COUNTER_H_ */
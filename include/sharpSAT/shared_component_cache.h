@@ -0,0 +1,91 @@
+/*
+ * shared_component_cache.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef SHARP_SAT_SHARED_COMPONENT_CACHE_H_
+#define SHARP_SAT_SHARED_COMPONENT_CACHE_H_
+
+#include <sharpSAT/statistics.h>
+#include <sharpSAT/component_types/cacheable_component.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace sharpSAT {
+
+/*!
+ * Model counts of components shared by all solvers counting in parallel.
+ *
+ * Unlike \ref ComponentCache it keeps neither a descendants tree nor
+ * unsolved entries, it only maps packed components to their model counts.
+ * The table is split into shards by the `hashkey()` of the components,
+ * each shard has its own lock and its own share of the memory bound.
+ *
+ * All solvers sharing the cache have to pack components alike,
+ * i.e. they have to work on the same preprocessed formula.
+ */
+class SharedComponentCache {
+public:
+  SharedComponentCache(uint64_t maximum_cache_size_bytes,
+      SharedCacheStatistics &statistics);
+
+  SharedComponentCache(const SharedComponentCache&) = delete;
+  SharedComponentCache &operator=(const SharedComponentCache&) = delete;
+
+  /*!
+   * Looks up the model count of packed_comp.
+   *
+   * \returns `true` if it has been found and stored in `model_count`
+   */
+  bool lookUp(const CacheableComponent &packed_comp, ModelCount &model_count);
+
+  // stores model_count as the model count of packed_comp
+  void store(const CacheableComponent &packed_comp,
+      const ModelCount &model_count);
+
+private:
+  struct Entry {
+    std::vector<unsigned> data;
+    unsigned hashkey = 0;
+    unsigned creation_time = 0;
+    unsigned next_bucket_element = 0;
+    ModelCount model_count;
+
+    uint64_t SizeInBytes() const {
+      return sizeof(Entry) + data.capacity() * sizeof(unsigned)
+          + model_count.heap_byte_size();
+    }
+  };
+
+  struct Shard {
+    std::mutex mutex;
+    // entry 0 is a dummy, 0 marks the end of a bucket
+    std::vector<Entry> entry_base;
+    std::vector<unsigned> free_entry_base_slots;
+    std::vector<unsigned> table;
+    uint64_t bytes_memory_usage = 0;
+    unsigned time = 0;
+  };
+
+  Shard &shardOf(unsigned hashkey) {
+    return shards_[hashkey >> (32 - num_shard_bits_)];
+  }
+
+  // requires the lock of shard
+  unsigned find(Shard &shard, const CacheableComponent &packed_comp);
+  void reHashTable(Shard &shard, unsigned size);
+  void deleteEntries(Shard &shard);
+
+  static const unsigned num_shard_bits_ = 6;
+
+  std::unique_ptr<Shard[]> shards_;
+  uint64_t maximum_shard_size_bytes_;
+
+  SharedCacheStatistics &statistics_;
+};
+} // sharpSAT namespace
+#endif /* SHARED_COMPONENT_CACHE_H_ */
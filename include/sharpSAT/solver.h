@@ -14,17 +14,32 @@
 #include <sharpSAT/component_management.h>
 #include <sharpSAT/solver_config.h>
 #include <sharpSAT/stopwatch.h>
+#include <sharpSAT/parallel_counter.h>
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
 
 namespace sharpSAT {
 
 enum class retStateT {
-	EXIT, RESOLVED, PROCESS_COMPONENT, BACKTRACK
+	EXIT, RESOLVED, PROCESS_COMPONENT, BACKTRACK, ABORT
 };
 
 class Solver: public Instance {
 public:
 	Solver():
-        comp_manager_(config_, statistics_, literal_values_) {
+        comp_manager_(config_, statistics_, literal_values_,
+				literal_weights_, projection_) {
+		stopwatch_.setTimeBound(config_.time_bound_seconds);
+	}
+
+	// a solver for the (already preprocessed) formula
+	explicit Solver(const Instance &formula):
+		Instance(formula),
+		comp_manager_(config_, statistics_, literal_values_,
+				literal_weights_, projection_) {
 		stopwatch_.setTimeBound(config_.time_bound_seconds);
 	}
 
@@ -44,6 +59,75 @@ public:
 
 	void load_and_solve(const std::string & file_name);
 
+	/*!
+	 * Counts the models of the formula under the assumed literals.
+	 *
+	 * The first call preprocesses the formula loaded via the \ref Instance
+	 * public API, later calls count the same formula under other
+	 * assumptions and reuse the model counts of all components cached
+	 * so far. Components are counted sequentially.
+	 *
+	 * \param[in] assumptions literals of the variables of the formula
+	 *   as loaded, which are set at decision level 0
+	 *
+	 * \returns `true` if `count` holds the model count, `false` on timeout
+	 */
+	bool count(const std::vector<LiteralID> &assumptions, ModelCount &count);
+
+	// prints the model count of the formula in file_name under each set
+	// of literals in assumptions_file, given like the clauses of a CNF file
+	void load_and_count(const std::string &file_name,
+			const std::string &assumptions_file);
+
+	/*!
+	 * Splits the formula into cubes, by branching on the variables
+	 * occurring most often down to `depth` decision levels. Branches
+	 * refuted by unit propagation are left out.
+	 *
+	 * The cubes are pairwise contradictory, and the model counts of the
+	 * formula under each cube sum up to its model count.
+	 *
+	 * \param[out] cubes literals of the formula as loaded
+	 */
+	void split(unsigned depth, std::vector<std::vector<LiteralID>> &cubes);
+
+	// writes each cube of the formula in file_name to dir/cube_<i>.cnf,
+	// the formula with the cube as unit clauses, and all cubes
+	// to dir/cubes, given like the clauses of a CNF file
+	void load_and_split(const std::string &file_name, unsigned depth,
+			const std::string &dir);
+
+	// prints the sum of the counts in dir/cube_<i>.txt,
+	// the output of the solver on dir/cube_<i>.cnf, over all cubes in dir
+	static void merge(const std::string &dir);
+
+	/*!
+	 * Counts the models of a single component of the formula.
+	 *
+	 * The formula has to be the preprocessed one, which the component
+	 * has been found in. The literals of `assignment` are set at
+	 * decision level 0 before the search is restricted to `comp`.
+	 *
+	 * \param[in] interrupt the search is given up once it is set
+	 *
+	 * \returns `true` if `count` holds the model count of `comp`,
+	 *   `false` on timeout or interrupt
+	 */
+	bool countComponent(const std::vector<LiteralID> &assignment,
+			const Component &comp, const std::atomic<bool> *interrupt,
+			ModelCount &count);
+
+	/*!
+	 * The model count of the formula with each literal true, indexed by
+	 * the literals of the formula as loaded.
+	 *
+	 * Set by \ref solve() if `config().compute_marginals` is, and the
+	 * count is complete and not projected, empty otherwise.
+	 */
+	const LiteralIndexedVector<ModelCount> &literalCounts() const {
+		return literal_counts_;
+	}
+
 	SolverConfiguration &config() {
 		return config_;
 	}
@@ -51,11 +135,22 @@ public:
 	DataAndStatistics &statistics() {
 	        return statistics_;
 	}
+	// model counts are also looked up in and stored to shared_cache
+	void setSharedCache(SharedComponentCache *shared_cache) {
+		comp_manager_.setSharedCache(shared_cache);
+	}
+
 	void setTimeBound(long int i) {
 		config().time_bound_seconds = i;
 		stopwatch_.setTimeBound(i);
 	}
 
+	// the search is given up like on timeout once *interrupt is set,
+	// e.g. by a signal handler, and saved if `config().checkpoint_file` is
+	void setInterrupt(const std::atomic<bool> *interrupt) {
+		interrupt_ = interrupt;
+	}
+
 private:
 	SolverConfiguration config_;
 
@@ -68,6 +163,101 @@ private:
 
 	ComponentManager comp_manager_;
 
+	// the formula has been loaded from a snapshot, i.e. is preprocessed
+	bool from_snapshot_ = false;
+
+	// count() has preprocessed the formula, which is kept from then on
+	bool counting_assumptions_ = false;
+	// split() is preprocessing the formula
+	bool splitting_ = false;
+	// preprocessing has found the formula unsatisfiable
+	bool formula_unsat_ = false;
+	// all model counts in the cache are final, so that
+	// the next count() may use them
+	bool cache_reusable_ = false;
+
+	// the marginals of the components being counted, if computed
+	std::unique_ptr<MarginalStack> marginal_stack_;
+	LiteralIndexedVector<ModelCount> literal_counts_;
+
+	// sets literal_counts_ from the marginals of the whole formula
+	void setLiteralCounts(const std::vector<ModelCount> &marginals);
+
+	// the search written as decision-DNNF, if asked for
+	std::unique_ptr<NnfTrace> nnf_trace_;
+
+	// opens nnf_trace_ with the literals set by preprocessing at its root
+	void startNnfTrace();
+
+	// the variable of the formula as loaded for each variable,
+	// empty if they are the same
+	VariableIndexedVector<VariableIndex> inputVariables();
+
+	// adds the cubes below the decisions in cube to cubes
+	void splitBelow(unsigned depth, std::vector<LiteralID> &cube,
+			std::vector<std::vector<LiteralID>> &cubes);
+
+	// the number of clauses lit occurs in,
+	// as the activity scores are initialized
+	unsigned occurrencesOf(LiteralID lit) {
+		return literal(lit).binary_links_.size() - 1
+				+ occurrence_lists_[lit].size();
+	}
+
+	// preprocessing keeps the free variables and records where the others
+	// went, which assumptions, cubes, marginals and the NNF trace need
+	bool keepFreeVariables() const {
+		return counting_assumptions_ || splitting_
+				|| config_.compute_marginals || !config_.nnf_file.empty();
+	}
+
+	// a snapshot lacks the variables preprocessing would have kept
+	bool usesSnapshot() const {
+		return !config_.snapshot_file.empty() && !keepFreeVariables();
+	}
+
+	std::string snapshotOptions() const {
+		return config_.perform_pre_processing ? "PP" : "noPP";
+	}
+
+	// the fingerprint of the preprocessed formula,
+	// taken before the search learns clauses
+	uint64_t formula_fingerprint_ = 0;
+
+	// marginals and the NNF trace cannot be resumed
+	bool checkpointing() const {
+		return !config_.checkpoint_file.empty() && !config_.compute_marginals
+				&& config_.nnf_file.empty();
+	}
+
+	// the state of the search at the head of the loop of countSAT(),
+	// from which countSAT() resumes once readCheckpoint() has read it
+	bool writeCheckpoint();
+	// returns false if config_.checkpoint_file holds no checkpoint
+	// of the formula
+	bool readCheckpoint();
+	std::string checkpointKey() const;
+	// the decision and literal stacks and the statistics of the search
+	void writeDecisionStack(BinaryWriter &out);
+	bool readDecisionStack(BinaryReader &in);
+
+	// counts components concurrently if config_.num_threads > 1
+	std::unique_ptr<SharedComponentCache> shared_cache_;
+	std::unique_ptr<ParallelComponentCounter> parallel_counter_;
+
+	// components of a decision level which are counted by the workers
+	struct DispatchedComponents {
+		// size of the decision stack when they were dispatched
+		unsigned stack_size;
+		// their positions in the component stack
+		std::vector<unsigned> comp_ids;
+		std::shared_ptr<ComponentBatch> batch;
+	};
+	std::vector<DispatchedComponents> dispatched_;
+
+	// set from outside the solver to stop the search
+	const std::atomic<bool> *interrupt_ = nullptr;
+
 	// the last time conflict clauses have been deleted
 	unsigned long last_ccl_deletion_time_ = 0;
 	// the last time the conflict clause storage has been compacted
@@ -114,6 +304,27 @@ private:
 
 	retStateT backtrack();
 
+	// the model count of the active branch of the top level is final
+	void finishMarginalsOfBranch() {
+		marginal_stack_->finishBranch(comp_manager_.superComponentOf(stack_.top()),
+				stack_.top().getActiveBranchModelCount(), literal_values_,
+				literal_weights_);
+	}
+
+	// hands large remaining components of top over to parallel_counter_
+	void dispatchRemainingComponentsOf(StackLevel &top);
+	// if a worker found a dispatched component to have no models,
+	// the search backtracks to the level which dispatched it
+	bool abandonBranchesWithUnsatComponents();
+	// waits for the components dispatched from top and includes
+	// their counts, returns false on timeout or interrupt
+	bool joinDispatchedComponentsOf(StackLevel &top);
+	void cancelDispatchedComponents();
+
+	bool interrupted() {
+		return interrupt_ != nullptr && interrupt_->load(std::memory_order_relaxed);
+	}
+
 	// if on the current decision level
 	// a second branch can be visited, RESOLVED is returned
 	// otherwise returns BACKTRACK
@@ -245,6 +456,13 @@ private:
 	//  possible clauses in between will be other UIP clauses
 	std::vector<std::vector<LiteralID> > uip_clauses_;
 
+	// buffers of implicitBCP() and of the conflict analysis,
+	// kept per solver so that they are allocated only once
+	std::vector<LiteralID> test_lits_;
+	LiteralIndexedVector<unsigned char> viewed_lits_;
+	std::vector<LiteralID> tmp_clause_;
+	std::deque<LiteralID> minimized_clause_;
+
 	// the assertion level of uip_clauses_.back()
 	// or (if the decision variable did not have an antecedent
 	// before) then assertionLevel_ == DL;
@@ -8,6 +8,8 @@
 #ifndef SHARP_SAT_SOLVER_CONFIG_H_
 #define SHARP_SAT_SOLVER_CONFIG_H_
 
+#include <string>
+
 namespace sharpSAT {
 
 struct SolverConfiguration {
@@ -21,6 +23,33 @@ struct SolverConfiguration {
 
   unsigned long time_bound_seconds = 100000;
 
+  // number of worker threads counting independent components,
+  // values below 2 mean that all components are counted sequentially
+  unsigned num_threads = 1;
+  // smaller components are not worth the overhead of a worker
+  // and are always counted by the thread which found them
+  unsigned parallel_min_component_vars = 100;
+
+  // if set, the preprocessed formula is loaded from this file, or saved
+  // to it if the file does not match the input
+  std::string snapshot_file;
+
+  // if set, the model counts of components are loaded from this file
+  // and saved to it once the count is complete
+  std::string cache_file;
+
+  // compute the model count with either literal of each variable true
+  // in the same search, unless the count is projected
+  bool compute_marginals = false;
+
+  // if set, the search is written to this file as a decision-DNNF
+  // in the NNF format of c2d, unless the count is projected
+  std::string nnf_file;
+
+  // if set, a search given up on timeout or interrupt saves its state
+  // to this file, and the next search of the same formula resumes it
+  std::string checkpoint_file;
+
   bool verbose = false;
 
   // quiet = true will override verbose;
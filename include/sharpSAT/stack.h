@@ -11,7 +11,8 @@
 #include <cassert>
 #include <vector>
 #include <cstddef>
-#include <gmpxx.h>
+
+#include <sharpSAT/count_types/model_count.h>
 
 namespace sharpSAT {
 
@@ -25,7 +26,7 @@ class StackLevel {
   const unsigned literal_stack_ofs_ = 0;
 
   //  Solutioncount
-  mpz_class branch_model_count_[2] = {0,0};
+  ModelCount branch_model_count_[2] = {0,0};
   bool branch_found_unsat_[2] = {false,false};
 
   /// remaining Components
@@ -62,6 +63,9 @@ public:
   unsigned remaining_components_ofs() {
     return remaining_components_ofs_;
   }
+  unsigned unprocessed_components_end() {
+    return unprocessed_components_end_;
+  }
   void set_unprocessed_components_end(unsigned end) {
     unprocessed_components_end_ = end;
     assert(remaining_components_ofs_ <= unprocessed_components_end_);
@@ -95,7 +99,7 @@ public:
   unsigned literal_stack_ofs() {
     return literal_stack_ofs_;
   }
-  void includeSolution(const mpz_class &solutions) {
+  void includeSolution(const ModelCount &solutions) {
     if (branch_found_unsat_[active_branch_]) {
       assert(branch_model_count_[active_branch_] == 0);
       return;
@@ -135,9 +139,25 @@ public:
 //	  branch_model_count_[0] = branch_model_count_[1] = 0;
 //	  active_branch_ = 1;
 //  }
-  const mpz_class getTotalModelCount() const {
+  const ModelCount &getActiveBranchModelCount() const {
+    return branch_model_count_[active_branch_];
+  }
+  const ModelCount getTotalModelCount() const {
     return branch_model_count_[0] + branch_model_count_[1];
   }
+
+  // the state of either branch, as saved by checkpoints
+  const ModelCount &branch_model_count(unsigned branch) const {
+    return branch_model_count_[branch];
+  }
+  bool branch_found_unsat(unsigned branch) const {
+    return branch_found_unsat_[branch];
+  }
+  void set_branch(unsigned branch, const ModelCount &model_count,
+      bool found_unsat) {
+    branch_model_count_[branch] = model_count;
+    branch_found_unsat_[branch] = found_unsat;
+  }
 }; // StackLevel
 
 class DecisionStack: public std::vector<StackLevel> {
@@ -11,9 +11,12 @@
 #include <sharpSAT/structures.h>
 #include <sharpSAT/component_types/cacheable_component.h>
 #include <sharpSAT/primitive_types.h>
+#include <sharpSAT/count_types/model_count.h>
 
+#include <atomic>
 #include <string>
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 #include <cstddef>
@@ -21,6 +24,15 @@
 
 namespace sharpSAT {
 
+// statistics of the SharedComponentCache,
+// updated concurrently by all threads using it
+struct SharedCacheStatistics {
+  std::atomic<uint64_t> bytes_memory_usage_{0};
+  std::atomic<uint64_t> num_look_ups_{0};
+  std::atomic<uint64_t> num_hits_{0};
+  std::atomic<uint64_t> num_stores_{0};
+};
+
 class DataAndStatistics {
 public:
   std::string input_file_;
@@ -67,6 +79,11 @@ public:
   // number of clauses overall learned
   unsigned num_clauses_learned_ = 0;
 
+  // number of components counted by worker threads
+  unsigned long num_dispatched_components_ = 0;
+  // only present when counting in parallel
+  std::shared_ptr<SharedCacheStatistics> shared_cache_statistics_;
+
 
   /* cache statistics */
   uint64_t num_cache_hits_ = 0;
@@ -142,7 +159,7 @@ public:
   unsigned long cache_MB_memory_usage() {
       return cache_bytes_memory_usage() / 1000000;
   }
-  mpz_class final_solution_count_ = 0;
+  ModelCount final_solution_count_ = 0;
 
   double implicitBCP_miss_rate() {
       if(num_failed_literal_tests_ == 0) return 0.0;
@@ -159,12 +176,19 @@ public:
     return 10000 + 10 * times_conflict_clauses_cleaned_;
   }
 
-  void set_final_solution_count(const mpz_class &count) {
+  void set_final_solution_count(const ModelCount &count) {
     // set final_solution_count_ = count * 2^(num_variables_ - num_used_variables_)
-    mpz_mul_2exp(final_solution_count_.get_mpz_t (),count.get_mpz_t (), num_variables_ - num_used_variables_);
+    final_solution_count_ = count;
+    final_solution_count_.mul_2exp(num_variables_ - num_used_variables_);
+  }
+
+  // for weighted or projected counts, count has to include
+  // the weights of the unused variables already
+  void set_final_weighted_solution_count(const ModelCount &count) {
+    final_solution_count_ = count;
   }
 
-  const mpz_class &final_solution_count() const {
+  const ModelCount &final_solution_count() const {
     return final_solution_count_;
   }
 
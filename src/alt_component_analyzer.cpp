@@ -77,7 +77,7 @@ void AltComponentAnalyzer::initialize(LiteralIndexedVector<Literal> & literals,
     }
   }
 
-  ComponentArchetype::initArrays(max_variable_id_, max_clause_id_);
+  archetype_.initArrays(max_variable_id_, max_clause_id_);
   // the unified link list
   unified_variable_links_lists_pool_.clear();
   unified_variable_links_lists_pool_.push_back(0u);
@@ -6,10 +6,12 @@
  */
 
 #include <sharpSAT/component_cache.h>
+#include <sharpSAT/binary_file.h>
 #include <sharpSAT/stack.h>
 
 #include <algorithm>
 #include <iostream>
+#include <sstream>
 
 #ifdef __linux__
 
@@ -73,21 +75,28 @@ ComponentCache::ComponentCache(DataAndStatistics &statistics) :
 		statistics_(statistics) {
 }
 
-void ComponentCache::init(Component &super_comp, SolverConfiguration &config) {
+void ComponentCache::init(Component &super_comp, const PackSize &pack_size,
+    SolverConfiguration &config) {
 
 	if (config.verbose) {
-    	cout << sizeof(CacheableComponent) << " " << sizeof(mpz_class) << endl;
+    	cout << sizeof(CacheableComponent) << " " << sizeof(ModelCount) << endl;
 	}
 
-    CacheableComponent &packed_super_comp = *new CacheableComponent(super_comp);
+    CacheableComponent packed_super_comp(super_comp, pack_size);
 	my_time_ = 1;
 
+	for (auto &pentry : entry_base_)
+		if (pentry != nullptr)
+			deleteEntry(pentry);
 	entry_base_.clear();
+	marginals_.clear();
+	nnf_nodes_.clear();
 	entry_base_.reserve(2000000);
-	entry_base_.push_back(new CacheableComponent()); // dummy Element
+	entry_base_.push_back(newEntry(CacheableComponent())); // dummy Element
 	table_.clear();
-	table_.resize(1024*1024, 0);
+	table_.resize(1024*1024);
 	table_size_mask_ = table_.size() - 1;
+	num_table_entries_ = 0;
 
 	free_entry_base_slots_.clear();
 	free_entry_base_slots_.reserve(10000);
@@ -117,11 +126,150 @@ void ComponentCache::init(Component &super_comp, SolverConfiguration &config) {
 	if (entry_base_.capacity() == entry_base_.size())
 		entry_base_.reserve(2 * entry_base_.size());
 
-	entry_base_.push_back(&packed_super_comp);
+	entry_base_.push_back(newEntry(std::move(packed_super_comp)));
 
-	statistics_.incorporate_cache_store(packed_super_comp);
+	statistics_.incorporate_cache_store(*entry_base_.back());
 
 	super_comp.set_id(1);
+
+	if (!config.cache_file.empty() && formula_fingerprint_) {
+		unsigned num_loaded = loadModelCounts(config.cache_file);
+		if (config.verbose)
+			cout << num_loaded << " model counts loaded from "
+				<< config.cache_file << endl;
+	}
+}
+
+string ComponentCache::modelCountsKey() const {
+	const uint32_t byte_order = 0x01020304;
+	ostringstream key;
+	key << "sharpSAT cache 1 " << MODEL_COUNT_TYPE << ' '
+		<< static_cast<unsigned>(*reinterpret_cast<const uint8_t *>(&byte_order))
+		<< ' ' << sizeof(unsigned) << ' ' << hex << formula_fingerprint_;
+	return key.str();
+}
+
+unsigned ComponentCache::loadModelCounts(const string &file_name) {
+	BinaryReader in;
+	string key;
+	uint64_t num_entries;
+	if (!in.open(file_name) || !in.readString(key) || key != modelCountsKey()
+			|| !in.readValue(num_entries))
+		return 0;
+	unsigned num_loaded = 0;
+	unsigned hashkey;
+	vector<unsigned> data;
+	ModelCount model_count;
+	// the loaded entries hang below the super component, they are
+	// final and never involved in cache pollutions
+	while (num_loaded < num_entries && !statistics_.cache_full()) {
+		if (!in.readValue(hashkey) || !in.readArray(data) || data.empty()
+				|| !in.readCount(model_count))
+			break;
+		CacheEntryID id = storeAsEntry(
+				CacheableComponent(data.data(), data.size(), hashkey), 1);
+		entry(id).set_deletable();
+		// modelCountFound() needs some time to have passed since creation
+		entry(id).set_creation_time(0);
+		storeValueOf(id, model_count);
+		num_loaded++;
+	}
+	return num_loaded;
+}
+
+bool ComponentCache::saveModelCounts(const string &file_name) {
+	BinaryWriter out(file_name);
+	out.writeString(modelCountsKey());
+	uint64_t num_entries = 0;
+	for (unsigned id = 2; id < entry_base_.size(); id++)
+		if (entry_base_[id] != nullptr && entry_base_[id]->modelCountFound())
+			num_entries++;
+	out.writeValue(num_entries);
+	for (unsigned id = 2; id < entry_base_.size(); id++)
+		if (entry_base_[id] != nullptr && entry_base_[id]->modelCountFound()) {
+			out.writeValue(entry_base_[id]->hashkey());
+			out.writeArray(entry_base_[id]->data(),
+					entry_base_[id]->data_size());
+			out.writeCount(entry_base_[id]->model_count());
+		}
+	return out.commit();
+}
+
+void ComponentCache::writeEntries(BinaryWriter &out) {
+	out.writeValue<uint64_t>(entry_base_.size());
+	for (auto pentry : entry_base_) {
+		out.writeValue<uint8_t>(pentry != nullptr);
+		if (pentry == nullptr)
+			continue;
+		out.writeValue(pentry->hashkey());
+		out.writeArray(pentry->data(), pentry->data_size());
+		out.writeCount(pentry->model_count());
+		out.writeValue(pentry->creation_time());
+		out.writeValue(pentry->length_solution_period_and_flags());
+		out.writeValue(pentry->father());
+		out.writeValue(pentry->first_descendant());
+		out.writeValue(pentry->next_sibling());
+	}
+	out.writeArray(free_entry_base_slots_);
+	out.writeValue<uint64_t>(table_.size());
+	out.writeValue<uint64_t>(my_time_);
+}
+
+bool ComponentCache::readEntries(BinaryReader &in) {
+	uint64_t num_entries;
+	if (!in.readValue(num_entries) || num_entries < 2
+			|| num_entries > in.size())
+		return false;
+	for (auto &pentry : entry_base_)
+		if (pentry != nullptr) {
+			statistics_.incorporate_cache_erase(*pentry);
+			deleteEntry(pentry);
+		}
+	entry_base_.assign(num_entries, nullptr);
+	marginals_.clear();
+	nnf_nodes_.clear();
+
+	vector<unsigned> data;
+	for (auto &pentry : entry_base_) {
+		uint8_t present;
+		if (!in.readValue(present))
+			return false;
+		if (!present)
+			continue;
+		unsigned hashkey, creation_time, period_and_flags;
+		ModelCount model_count;
+		CacheEntryID links[3];
+		if (!in.readValue(hashkey) || !in.readArray(data)
+				|| !in.readCount(model_count) || !in.readValue(creation_time)
+				|| !in.readValue(period_and_flags) || !in.readValue(links))
+			return false;
+		for (auto id : links)
+			if (id >= num_entries)
+				return false;
+		pentry = newEntry(data.empty() ? CacheableComponent() :
+				CacheableComponent(data.data(), data.size(), hashkey));
+		pentry->set_model_count(model_count, creation_time);
+		pentry->set_creation_time(creation_time);
+		pentry->set_length_solution_period_and_flags(period_and_flags);
+		pentry->set_father(links[0]);
+		pentry->set_first_descendant(links[1]);
+		pentry->set_next_sibling(links[2]);
+		statistics_.incorporate_cache_store(*pentry);
+	}
+
+	uint64_t table_size, my_time;
+	if (!in.readArray(free_entry_base_slots_) || !in.readValue(table_size)
+			|| !in.readValue(my_time) || table_size == 0
+			|| (table_size & (table_size - 1)) != 0
+			|| table_size > (uint64_t(1) << 32))
+		return false;
+	for (auto id : free_entry_base_slots_)
+		if (id >= num_entries || entry_base_[id] != nullptr)
+			return false;
+	my_time_ = my_time;
+	reHashTable(table_size);
+	compute_byte_size_infrasture();
+	return true;
 }
 
 void ComponentCache::test_descendantstree_consistency() {
@@ -178,6 +326,7 @@ bool ComponentCache::deleteEntries() {
 				eraseEntry(id);
 
         }
+	compactSlabs();
 	// then go through the Hash Table and erase all Links to empty entries
 
 
@@ -202,6 +351,7 @@ bool ComponentCache::deleteEntries() {
 			    entry_base_[id]->data_only_byte_size();
 			 statistics_.sys_overhead_sum_bytes_cached_components_ +=
 			     entry_base_[id]->sys_overhead_SizeInBytes();
+			statistics_.sum_bytes_cached_components_ += marginalsBytes(id);
 		}
 
 	statistics_.num_cached_components_ = entry_base_.size();
@@ -212,12 +362,44 @@ bool ComponentCache::deleteEntries() {
 }
 
 
+void ComponentCache::compactSlabs() {
+	SlabAllocator<CacheableComponent> entry_slabs;
+	SlabAllocator<unsigned> data_slabs;
+	for (auto &pentry : entry_base_)
+		if (pentry != nullptr) {
+			CacheableComponent *pmoved = new (entry_slabs.allocate(1))
+					CacheableComponent(std::move(*pentry));
+			// data_ outside of the slabs stays where it is
+			if (pmoved->data() && data_slabs.pooled(pmoved->data_size())) {
+				unsigned *data = data_slabs.allocate(pmoved->data_size());
+				copy(pmoved->data(), pmoved->data() + pmoved->data_size(), data);
+				pmoved->set_data(data);
+			}
+			pentry->~CacheableComponent();
+			pentry = pmoved;
+		}
+	// the old slabs are released
+	entry_slabs_.swap(entry_slabs);
+	data_slabs_.swap(data_slabs);
+}
+
+void ComponentCache::publishModelCounts() {
+	if (shared_cache_ == nullptr)
+		return;
+	for (unsigned id = 1; id < entry_base_.size(); id++)
+		if (entry_base_[id] != nullptr && entry_base_[id]->modelCountFound())
+			shared_cache_->store(*entry_base_[id], entry_base_[id]->model_count());
+}
+
 uint64_t ComponentCache::compute_byte_size_infrasture() {
   statistics_.cache_infrastructure_bytes_memory_usage_ =
       sizeof(ComponentCache)
-      + sizeof(CacheEntryID)* table_.capacity()
+      + entry_slabs_.bytes_free() + data_slabs_.bytes_free()
+      + sizeof(TableSlot)* table_.capacity()
       + sizeof(CacheableComponent *)* entry_base_.capacity()
-      + sizeof(CacheEntryID) * free_entry_base_slots_.capacity();
+      + sizeof(CacheEntryID) * free_entry_base_slots_.capacity()
+      + sizeof(std::vector<ModelCount>) * marginals_.capacity()
+      + sizeof(unsigned) * nnf_nodes_.capacity();
   return statistics_.cache_infrastructure_bytes_memory_usage_;
 }
 
@@ -6,6 +6,9 @@
  */
 
 #include <sharpSAT/component_management.h>
+#include <sharpSAT/binary_file.h>
+
+#include <algorithm>
 
 using namespace std;
 
@@ -15,21 +18,107 @@ void ComponentManager::initialize(LiteralIndexedVector<Literal> & literals,
     vector<LiteralID> &lit_pool) {
 
   ana_.initialize(literals, lit_pool);
+
+  Component *root_comp = new Component();
+  root_comp->createAsDummyComponent(ana_.max_variable_id(),
+      ana_.max_clause_id());
+  initializeComponentStack(root_comp);
+}
+
+void ComponentManager::initialize(LiteralIndexedVector<Literal> & literals,
+    vector<LiteralID> &lit_pool, const Component &root_comp) {
+
+  ana_.initialize(literals, lit_pool);
+  initializeComponentStack(new Component(root_comp));
+}
+
+void ComponentManager::reinitialize() {
+  // the counts of the components left on the stack may be deleted
+  // from the cache later on, like those of all others
+  for (unsigned u = 2; u < component_stack_.size(); u++)
+    if (cache_.hasEntry(component_stack_[u]->id()))
+      cache_.entry(component_stack_[u]->id()).set_deletable();
+  Component *root_comp = new Component();
+  root_comp->createAsDummyComponent(ana_.max_variable_id(),
+      ana_.max_clause_id());
+  resetComponentStack(root_comp);
+  cache_.restart(*root_comp);
+}
+
+void ComponentManager::initializeComponentStack(Component *root_comp) {
   // BEGIN CACHE INIT
-  CacheableComponent::adjustPackSize(ana_.max_variable_id(), ana_.max_clause_id());
+  pack_size_ = PackSize(ana_.max_variable_id(), ana_.max_clause_id());
+  resetComponentStack(root_comp);
+  cache_.init(*root_comp, pack_size_, config_);
+}
 
+void ComponentManager::resetComponentStack(Component *root_comp) {
+  for (auto* ptr : component_stack_)
+    delete ptr;
   component_stack_.clear();
   component_stack_.reserve(static_cast<unsigned>(ana_.max_variable_id()) + 2);
   component_stack_.push_back(new Component());
-  component_stack_.push_back(new Component());
+  component_stack_.push_back(root_comp);
   assert(component_stack_.size() == 2);
-  component_stack_.back()->createAsDummyComponent(ana_.max_variable_id(),
-      ana_.max_clause_id());
+}
 
 
-  cache_.init(*component_stack_.back(), config_);
+void ComponentManager::writeSearchState(BinaryWriter &out) {
+  out.writeArray(ana_.var_frequency_scores());
+  out.writeValue<uint64_t>(component_stack_.size());
+  vector<unsigned> vars, clauses;
+  // the first component is an empty dummy
+  for (unsigned u = 1; u < component_stack_.size(); u++) {
+    Component &comp = *component_stack_[u];
+    vars.clear();
+    for (auto it = comp.varsBegin(); it->get<VariableIndex>() != varsSENTINEL;
+        it++)
+      vars.push_back(static_cast<unsigned>(it->get<VariableIndex>()));
+    clauses.clear();
+    for (auto it = comp.clsBegin(); it->get<ClauseIndex>() != clsSENTINEL;
+        it++)
+      clauses.push_back(static_cast<unsigned>(it->get<ClauseIndex>()));
+    out.writeValue(comp.id());
+    out.writeArray(vars);
+    out.writeArray(clauses);
+  }
+  cache_.writeEntries(out);
 }
 
+bool ComponentManager::readSearchState(BinaryReader &in) {
+  vector<unsigned> scores;
+  uint64_t num_comps;
+  if (!in.readArray(scores)
+      || scores.size() != ana_.var_frequency_scores().size()
+      || !in.readValue(num_comps) || num_comps < 2 || num_comps > in.size())
+    return false;
+  ana_.var_frequency_scores().swap(scores);
+
+  for (auto* ptr : component_stack_)
+    delete ptr;
+  component_stack_.clear();
+  component_stack_.push_back(new Component());
+  vector<unsigned> vars, clauses;
+  for (unsigned u = 1; u < num_comps; u++) {
+    CacheEntryID id;
+    // 0 is the sentinel of either list
+    if (!in.readValue(id) || !in.readArray(vars) || !in.readArray(clauses)
+        || find(vars.begin(), vars.end(), 0) != vars.end()
+        || find(clauses.begin(), clauses.end(), 0) != clauses.end())
+      return false;
+    Component *comp = new Component();
+    comp->reserveSpace(vars.size(), clauses.size());
+    for (auto v : vars)
+      comp->addVar(VariableIndex(v));
+    comp->closeVariableData();
+    for (auto cl : clauses)
+      comp->addCl(ClauseIndex(cl));
+    comp->closeClauseData();
+    comp->set_id(id);
+    component_stack_.push_back(comp);
+  }
+  return cache_.readEntries(in);
+}
 
 void ComponentManager::removeAllCachePollutionsOf(StackLevel &top) {
   // all processed components are found in
@@ -52,4 +141,35 @@ void ComponentManager::removeAllCachePollutionsOf(StackLevel &top) {
   cache_.test_descendantstree_consistency();
 #endif
 }
+
+void ComponentManager::detachRemainingCompsOf(StackLevel &top,
+    unsigned min_vars, vector<unsigned> &comp_ids) {
+  comp_ids.clear();
+  // only components which have just been recorded
+  if (top.unprocessed_components_end() != component_stack_.size())
+    return;
+
+  auto begin = component_stack_.begin() + top.remaining_components_ofs();
+  auto end = component_stack_.end();
+  Component *largest = nullptr;
+  unsigned num_large = 0;
+  for (auto it = begin; it != end; it++)
+    if ((*it)->num_variables() >= min_vars) {
+      num_large++;
+      if (largest == nullptr
+          || (*it)->num_variables() > largest->num_variables())
+        largest = *it;
+    }
+  if (num_large < 2)
+    return;
+
+  // the processed part of the range is at its end
+  stable_partition(begin, end, [&](Component *comp) {
+    return comp == largest || comp->num_variables() < min_vars;
+  });
+  top.set_unprocessed_components_end(component_stack_.size() - (num_large - 1));
+  for (unsigned u = top.unprocessed_components_end();
+      u < component_stack_.size(); u++)
+    comp_ids.push_back(u);
+}
 } // sharpSAT namespace
@@ -0,0 +1,102 @@
+/*
+ * hybrid_count.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <sharpSAT/count_types/hybrid_count.h>
+
+namespace sharpSAT {
+
+void HybridCount::mul_2exp(unsigned long exponent) {
+  if (!big_) {
+    uint128 value = native();
+    if (value == 0 || exponent == 0)
+      return;
+    if (exponent < 128 && (value >> (128 - exponent)) == 0) {
+      set_native(value << exponent);
+      return;
+    }
+    promote();
+  }
+  mpz_mul_2exp(big_->get_mpz_t(), big_->get_mpz_t(), exponent);
+}
+
+mpz_class HybridCount::get_mpz() const {
+  if (big_)
+    return *big_;
+  mpz_class value;
+  uint64_t words[2] = {lo_, hi_};
+  mpz_import(value.get_mpz_t(), 2, -1, sizeof(uint64_t), 0, 0, words);
+  return value;
+}
+
+std::string HybridCount::to_bytes() const {
+  if (big_) {
+    std::string bytes(mpz_sizeinbase(big_->get_mpz_t(), 256), '\0');
+    size_t size = 0;
+    mpz_export(&bytes[0], &size, -1, 1, 0, 0, big_->get_mpz_t());
+    bytes.resize(size);
+    return bytes;
+  }
+  std::string bytes(2 * sizeof(uint64_t), '\0');
+  for (unsigned i = 0; i < sizeof(uint64_t); i++) {
+    bytes[i] = static_cast<char>(lo_ >> (8 * i));
+    bytes[sizeof(uint64_t) + i] = static_cast<char>(hi_ >> (8 * i));
+  }
+  return bytes;
+}
+
+bool HybridCount::from_bytes(const std::string &bytes, HybridCount &count) {
+  if (bytes.size() > 2 * sizeof(uint64_t)) {
+    mpz_class value;
+    mpz_import(value.get_mpz_t(), bytes.size(), -1, 1, 0, 0, bytes.data());
+    count = HybridCount();
+    count.big_ = new mpz_class(value);
+    return true;
+  }
+  uint128 value = 0;
+  for (size_t i = bytes.size(); i-- > 0;)
+    value = (value << 8) | static_cast<unsigned char>(bytes[i]);
+  count = HybridCount();
+  count.set_native(value);
+  return true;
+}
+
+bool HybridCount::from_str(const std::string &str, HybridCount &count) {
+  mpz_class value;
+  if (str.empty() || str[0] == '-' || value.set_str(str, 10) != 0)
+    return false;
+  count = HybridCount();
+  if (mpz_sizeinbase(value.get_mpz_t(), 2) > 128) {
+    count.big_ = new mpz_class(value);
+    return true;
+  }
+  uint64_t words[2] = {0, 0};
+  mpz_export(words, nullptr, -1, sizeof(uint64_t), 0, 0, value.get_mpz_t());
+  count.lo_ = words[0];
+  count.hi_ = words[1];
+  return true;
+}
+
+void HybridCount::promote() {
+  if (!big_)
+    big_ = new mpz_class(get_mpz());
+}
+
+void HybridCount::multiplyBig(const HybridCount &other) {
+  promote();
+  if (other.big_)
+    *big_ *= *other.big_;
+  else
+    *big_ *= other.get_mpz();
+}
+
+void HybridCount::addBig(const HybridCount &other) {
+  promote();
+  if (other.big_)
+    *big_ += *other.big_;
+  else
+    *big_ += other.get_mpz();
+}
+} // sharpSAT namespace
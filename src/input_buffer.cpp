@@ -0,0 +1,311 @@
+/*
+ * input_buffer.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <sharpSAT/input_buffer.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef SHARPSAT_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef SHARPSAT_HAVE_LZMA
+#include <lzma.h>
+#endif
+#ifdef SHARPSAT_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+using namespace std;
+
+namespace sharpSAT {
+
+/*!
+ * Reads the decompressed contents of a file chunk by chunk.
+ */
+class Decompressor {
+public:
+  virtual ~Decompressor() {}
+
+  // decompresses up to size bytes into buffer,
+  // returns the number of bytes, which is 0 only at the end of the file
+  virtual size_t read(char *buffer, size_t size) = 0;
+
+protected:
+  static void fail(const char *format) {
+    cerr << "Corrupt " << format << " input" << endl;
+    exit(1);
+  }
+};
+
+namespace {
+
+enum class Compression {
+  NONE, GZIP, XZ, ZSTD
+};
+
+const size_t CHUNK_SIZE = 1 << 20;
+
+Compression compressionOf(const string &file_name) {
+  unsigned char magic[6] = {};
+  ifstream probe(file_name, ios::binary);
+  probe.read(reinterpret_cast<char *>(magic), sizeof(magic));
+  if (magic[0] == 0x1f && magic[1] == 0x8b)
+    return Compression::GZIP;
+  if (memcmp(magic, "\xfd" "7zXZ\0", 6) == 0)
+    return Compression::XZ;
+  if (memcmp(magic, "\x28\xb5\x2f\xfd", 4) == 0)
+    return Compression::ZSTD;
+  return Compression::NONE;
+}
+
+#ifdef SHARPSAT_HAVE_ZLIB
+class GzipDecompressor: public Decompressor {
+public:
+  explicit GzipDecompressor(gzFile file) : file_(file) {
+    gzbuffer(file_, 1 << 17);
+  }
+  ~GzipDecompressor() {
+    gzclose(file_);
+  }
+
+  size_t read(char *buffer, size_t size) override {
+    int bytes = gzread(file_, buffer, static_cast<unsigned>(size));
+    if (bytes <= 0) {
+      // a truncated file shows only at its end
+      int error = Z_OK;
+      gzerror(file_, &error);
+      if (bytes < 0 || error != Z_OK)
+        fail("gzip");
+      return 0;
+    }
+    return static_cast<size_t>(bytes);
+  }
+
+private:
+  gzFile file_;
+};
+#endif
+
+#ifdef SHARPSAT_HAVE_LZMA
+class XzDecompressor: public Decompressor {
+public:
+  explicit XzDecompressor(FILE *file) : file_(file), input_(CHUNK_SIZE) {
+    if (lzma_stream_decoder(&stream_, UINT64_MAX, LZMA_CONCATENATED)
+        != LZMA_OK)
+      fail("xz");
+  }
+  ~XzDecompressor() {
+    lzma_end(&stream_);
+    fclose(file_);
+  }
+
+  size_t read(char *buffer, size_t size) override {
+    stream_.next_out = reinterpret_cast<uint8_t *>(buffer);
+    stream_.avail_out = size;
+    while (stream_.avail_out > 0 && !finished_) {
+      if (stream_.avail_in == 0 && !feof(file_)) {
+        stream_.next_in = input_.data();
+        stream_.avail_in = fread(input_.data(), 1, input_.size(), file_);
+      }
+      lzma_ret ret = lzma_code(&stream_, feof(file_) ? LZMA_FINISH : LZMA_RUN);
+      if (ret == LZMA_STREAM_END)
+        finished_ = true;
+      else if (ret != LZMA_OK)
+        fail("xz");
+    }
+    return size - stream_.avail_out;
+  }
+
+private:
+  FILE *file_;
+  vector<uint8_t> input_;
+  lzma_stream stream_ = LZMA_STREAM_INIT;
+  bool finished_ = false;
+};
+#endif
+
+#ifdef SHARPSAT_HAVE_ZSTD
+class ZstdDecompressor: public Decompressor {
+public:
+  explicit ZstdDecompressor(FILE *file) :
+      file_(file), input_(ZSTD_DStreamInSize()),
+      stream_(ZSTD_createDStream()) {
+    if (!stream_ || ZSTD_isError(ZSTD_initDStream(stream_)))
+      fail("zstd");
+  }
+  ~ZstdDecompressor() {
+    ZSTD_freeDStream(stream_);
+    fclose(file_);
+  }
+
+  size_t read(char *buffer, size_t size) override {
+    ZSTD_outBuffer output = { buffer, size, 0 };
+    while (output.pos < output.size) {
+      if (input_buffer_.pos == input_buffer_.size) {
+        input_buffer_.src = input_.data();
+        input_buffer_.size = fread(input_.data(), 1, input_.size(), file_);
+        input_buffer_.pos = 0;
+        if (input_buffer_.size == 0) {
+          // a frame must not end in the middle
+          if (frame_open_)
+            fail("zstd");
+          break;
+        }
+      }
+      size_t ret = ZSTD_decompressStream(stream_, &output, &input_buffer_);
+      if (ZSTD_isError(ret))
+        fail("zstd");
+      frame_open_ = ret != 0;
+    }
+    return output.pos;
+  }
+
+private:
+  FILE *file_;
+  vector<char> input_;
+  ZSTD_inBuffer input_buffer_ = { nullptr, 0, 0 };
+  ZSTD_DStream *stream_;
+  bool frame_open_ = false;
+};
+#endif
+
+// nullptr, if the build does not support the compression
+Decompressor *createDecompressor(const string &file_name,
+    Compression compression) {
+  switch (compression) {
+#ifdef SHARPSAT_HAVE_ZLIB
+  case Compression::GZIP: {
+    gzFile file = gzopen(file_name.c_str(), "rb");
+    return file ? new GzipDecompressor(file) : nullptr;
+  }
+#endif
+#ifdef SHARPSAT_HAVE_LZMA
+  case Compression::XZ: {
+    FILE *file = fopen(file_name.c_str(), "rb");
+    return file ? new XzDecompressor(file) : nullptr;
+  }
+#endif
+#ifdef SHARPSAT_HAVE_ZSTD
+  case Compression::ZSTD: {
+    FILE *file = fopen(file_name.c_str(), "rb");
+    return file ? new ZstdDecompressor(file) : nullptr;
+  }
+#endif
+  default:
+    cerr << "Compressed input is not supported by this build: "
+         << file_name << endl;
+    return nullptr;
+  }
+}
+
+} // anonymous namespace
+
+InputBuffer::InputBuffer() {}
+
+InputBuffer::~InputBuffer() {
+#ifndef _WIN32
+  if (mapping_)
+    munmap(mapping_, mapping_size_);
+#endif
+}
+
+bool InputBuffer::open(const string &file_name) {
+#ifndef _WIN32
+  int fd = ::open(file_name.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat file_status;
+  bool regular_file = fstat(fd, &file_status) == 0
+      && S_ISREG(file_status.st_mode);
+  if (regular_file)
+    file_size_ = static_cast<size_t>(file_status.st_size);
+  Compression compression = regular_file ?
+      compressionOf(file_name) : Compression::NONE;
+  if (compression == Compression::NONE && file_size_ > 0) {
+    void *mapping = mmap(nullptr, file_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping != MAP_FAILED) {
+      madvise(mapping, file_size_, MADV_SEQUENTIAL);
+      close(fd);
+      mapping_ = mapping;
+      mapping_size_ = file_size_;
+      pos_ = static_cast<const char *>(mapping);
+      end_ = pos_ + file_size_;
+      return true;
+    }
+  }
+  close(fd);
+#else
+  Compression compression = compressionOf(file_name);
+#endif
+  if (compression != Compression::NONE) {
+    decompressor_.reset(createDecompressor(file_name, compression));
+    data_.resize(CHUNK_SIZE);
+    return decompressor_ != nullptr;
+  }
+
+  // pipes and the like are read as a whole
+  ifstream input_file(file_name, ios::binary);
+  if (!input_file)
+    return false;
+  data_.assign(istreambuf_iterator<char>(input_file),
+      istreambuf_iterator<char>());
+  pos_ = data_.data();
+  end_ = pos_ + data_.size();
+  file_size_ = data_.size();
+  return true;
+}
+
+string InputBuffer::readLine() {
+  string line;
+  while (pos_ != end_ || refill()) {
+    auto line_end = static_cast<const char *>(
+        memchr(pos_, '\n', static_cast<size_t>(end_ - pos_)));
+    line.append(pos_, line_end ? line_end : end_);
+    if (line_end) {
+      pos_ = line_end + 1;
+      break;
+    }
+    pos_ = end_;
+  }
+  return line;
+}
+
+bool InputBuffer::readBytes(void *data, size_t size) {
+  char *dest = static_cast<char *>(data);
+  while (size > 0) {
+    if (pos_ == end_ && !refill())
+      return false;
+    size_t bytes = min(size, static_cast<size_t>(end_ - pos_));
+    memcpy(dest, pos_, bytes);
+    dest += bytes;
+    pos_ += bytes;
+    size -= bytes;
+  }
+  return true;
+}
+
+bool InputBuffer::refill() {
+  if (!decompressor_)
+    return false;
+  size_t bytes = decompressor_->read(data_.data(), data_.size());
+  pos_ = data_.data();
+  end_ = pos_ + bytes;
+  return bytes > 0;
+}
+
+} // sharpSAT namespace
@@ -6,11 +6,14 @@
  */
 
 #include <sharpSAT/instance.h>
+#include <sharpSAT/binary_file.h>
+#include <sharpSAT/input_buffer.h>
 
 #include <algorithm>
-#include <iostream>
+#include <cstring>
 #include <fstream>
-#include <sys/stat.h>
+#include <iostream>
+#include <sstream>
 
 using namespace std;
 
@@ -110,7 +113,7 @@ void Instance::compactClauses() {
   statistics_.num_binary_clauses_ = bin_links >> 1;
 }
 
-void Instance::compactVariables() {
+void Instance::compactVariables(bool keep_free_variables) {
   VariableIndexedVector<VariableIndex> var_map(variables_.size(), VariableIndex(0));
   VariableIndex last_ofs(0);
   unsigned num_isolated = 0;
@@ -123,7 +126,7 @@ void Instance::compactVariables() {
   assert(_tmp_bin_links.size() == literals_.size());
   for (VariableIndex v(1); v < VariableIndex(variables_.size()); ++v)
     if (isActive(LiteralID(v, true))) {
-      if (isolated(v)) {
+      if (isolated(v) && !keep_free_variables) {
         num_isolated++;
         continue;
       }
@@ -131,6 +134,35 @@ void Instance::compactVariables() {
       var_map[v] = last_ofs;
     }
 
+  if (weighted() || projected()) {
+    // the weights of removed variables are accounted for right here
+    LiteralIndexedVector<ModelCount> weights(
+        weighted() ? static_cast<unsigned>(last_ofs) + 1 : 0);
+    VariableIndexedVector<bool> projection(
+        projected() ? static_cast<unsigned>(last_ofs) + 1 : 0, false);
+    for (VariableIndex v(1); v < VariableIndex(variables_.size()); ++v) {
+      LiteralID lit(v, true);
+      if (var_map[v] != VariableIndex(0)) {
+        if (weighted()) {
+          weights[LiteralID(var_map[v], true)] = literal_weights_[lit];
+          weights[LiteralID(var_map[v], false)] = literal_weights_[lit.neg()];
+        }
+        if (projected())
+          projection[var_map[v]] = projection_[v];
+      } else if (!inProjection(v))
+        continue;
+      else if (isActive(lit))
+        removed_variables_weight_ *= weighted()
+            ? literal_weights_[lit] + literal_weights_[lit.neg()]
+            : ModelCount(2);
+      else if (weighted())
+        removed_variables_weight_ *=
+            literal_weights_[isSatisfied(lit) ? lit : lit.neg()];
+    }
+    literal_weights_ = weights;
+    projection_ = projection;
+  }
+
   variables_.clear();
   variables_.resize(static_cast<unsigned>(last_ofs) + 1);
   occurrence_lists_.clear();
@@ -182,12 +214,47 @@ void Instance::compactVariables() {
   literal_values_.resize(variables_.size(), TriValue::X_TRI);
   unit_clauses_.clear();
 
+  if (keep_free_variables) {
+    compacted_variables_ = var_map;
+    input_literal_values_ = _tmp_values;
+  }
+
   statistics_.num_variables_ = variables_.size() - 1 + num_isolated;
 
   statistics_.num_used_variables_ = num_variables();
   statistics_.num_free_variables_ = num_isolated;
 }
 
+bool Instance::compactedLiterals(const vector<LiteralID> &lits,
+    vector<LiteralID> &compacted) const {
+  compacted.clear();
+  if (compacted_variables_.empty()) {
+    compacted = lits;
+    return true;
+  }
+  for (auto lit : lits) {
+    VariableIndex v = compacted_variables_[lit.var()];
+    if (v != VariableIndex(0))
+      compacted.push_back(LiteralID(v, lit.sign()));
+    else if (input_literal_values_[lit] == TriValue::F_TRI)
+      return false;
+  }
+  return true;
+}
+
+void Instance::saveClauses() {
+  saved_literal_pool_ = literal_pool_;
+  saved_literals_ = literals_;
+  saved_unit_clauses_ = unit_clauses_;
+}
+
+void Instance::restoreClauses() {
+  literal_pool_ = saved_literal_pool_;
+  literals_ = saved_literals_;
+  unit_clauses_ = saved_unit_clauses_;
+  conflict_clauses_.clear();
+}
+
 void Instance::compactConflictLiteralPool(){
   auto write_pos = conflict_clauses_begin();
   vector<ClauseOfs> tmp_conflict_clauses = conflict_clauses_;
@@ -305,6 +372,10 @@ void Instance::initialize(
 
   literals_.clear();
   literals_.resize(nVars + 1);
+
+  literal_weights_.clear();
+  projection_.clear();
+  removed_variables_weight_ = 1;
 }
 
 
@@ -320,6 +391,19 @@ void Instance::add_clause(std::vector<LiteralID>& literals) {
 }
 
 
+bool Instance::set_literal_weight(LiteralID lit, long double weight) {
+  if (literal_weights_.empty())
+    literal_weights_.resize(variables_.size(), ModelCount(1));
+  return ModelCount::from_weight(weight, literal_weights_[lit]);
+}
+
+void Instance::set_projection(const vector<VariableIndex> &vars) {
+  projection_.assign(variables_.size(), false);
+  for (auto v : vars)
+    projection_[v] = true;
+}
+
+
 void Instance::finalize(unsigned int nVars, unsigned int nCls) {
   statistics_.num_variables_ = statistics_.num_original_variables_ = nVars;
   statistics_.num_used_variables_ = num_variables();
@@ -335,68 +419,144 @@ void Instance::finalize(unsigned int nVars, unsigned int nCls) {
 }
 
 
+// literal weights and projection variables declared in comment lines
+struct CommentDeclarations {
+  vector<pair<int, long double>> weights;
+  bool projected = false;
+  vector<int> projection;
+};
+
+// reads the rest of a comment line, which may declare
+// - the weight of a literal: 'c p weight [literal] [weight] 0'
+// - projection variables: 'c p show [variables] 0' or 'c ind [variables] 0'
+static void readCommentLine(const string &line,
+    CommentDeclarations &declarations) {
+  string keyword;
+  istringstream comment(line);
+  if (!(comment >> keyword))
+    return;
+  if (keyword == "p" && !(comment >> keyword))
+    return;
+
+  if (keyword == "weight") {
+    int lit;
+    long double weight;
+    if (!(comment >> lit >> weight) || lit == 0) {
+      cerr << "Invalid weight line: c" << line << endl;
+      exit(1);
+    }
+    declarations.weights.emplace_back(lit, weight);
+  } else if (keyword == "show" || keyword == "ind") {
+    declarations.projected = true;
+    int var;
+    while (comment >> var && var != 0) {
+      if (var < 0) {
+        cerr << "Invalid projection line: c" << line << endl;
+        exit(1);
+      }
+      declarations.projection.push_back(var);
+    }
+  }
+}
+
 bool Instance::createfromFile(const string &file_name) {
   unsigned int nVars; // #variables in the file
   unsigned int nCls; // #clauses in the file
   unsigned clauses_added = 0; // #clauses added to the instance
 
   // Start reading the file
-  ifstream input_file(file_name);
-  if (!input_file) {
+  InputBuffer input;
+  if (!input.open(file_name)) {
     cerr << "Cannot open file: " << file_name << endl;
     exit(0);
   }
 
   char c;
   // fast-forward to the 'p [variables] [clauses]' line
-  while (input_file >> c && c != 'p')
-    input_file.ignore(numeric_limits<streamsize>::max(), '\n');
+  CommentDeclarations declarations;
+  while ((c = input.peekNonSpace()) && c != 'p') {
+    input.skipChar();
+    if (c == 'c')
+      readCommentLine(input.readLine(), declarations);
+    else
+      input.skipLine();
+  }
+  input.skipChar();
 
+  istringstream problem_line(input.readLine());
   string idstring;
-  if (!(input_file >> idstring && idstring == "cnf" && input_file >> nVars
-      && input_file >> nCls)) {
+  if (!(problem_line >> idstring && idstring == "cnf"
+      && problem_line >> nVars && problem_line >> nCls)) {
     cerr << "Invalid CNF file" << endl;
     exit(1);
   }
 
-  // estimate literal count
-  struct stat filestatus;
-  stat(file_name.c_str(), &filestatus);
-  // prepare to be filled
-  initialize(nVars, nCls, filestatus.st_size);
+  // prepare to be filled, the file size is an estimate of the literal count
+  initialize(nVars, nCls, static_cast<unsigned>(input.size()));
 
 
   vector<LiteralID> literals;
   literals.reserve(10000);
-
-  while ((input_file >> c) && clauses_added < nCls) {
-    input_file.unget(); //extracted a nonspace character to determine if we have a clause, so put it back
-    if ((c == '-') || isdigit(c)) {
+  // literal_marks[lit] == clauses_read, iff lit occurs in the current clause
+  LiteralIndexedVector<unsigned> literal_marks(nVars + 1, 0);
+  unsigned clauses_read = 0;
+
+  // weight and projection lines may follow the last clause,
+  // so read up to the end
+  while ((c = input.peekNonSpace())) {
+    if (c == 'c') {
+      input.skipChar();
+      readCommentLine(input.readLine(), declarations);
+      continue;
+    }
+    if (((c == '-') || isdigit(c)) && clauses_added < nCls) {
       literals.clear();
       bool skip_clause = false;
+      clauses_read++;
       int lit; // current literal
-      while ((input_file >> lit) && lit != 0) {
-        bool duplicate_literal = false;
-        for (auto i : literals) {
-          if (i.toInt() == lit) {
-            duplicate_literal = true;
-            break;
-          }
-          if (i.toInt() == -lit) {
-            skip_clause = true;
-            break;
-          }
-        }
-        if (!duplicate_literal) {
-          literals.push_back(LiteralID(lit));
+      while (input.readInt(lit) && lit != 0) {
+        if (static_cast<unsigned>(abs(lit)) > nVars) {
+          cerr << "Invalid CNF file: literal " << lit << endl;
+          exit(1);
         }
+        LiteralID literal(lit);
+        if (literal_marks[literal] == clauses_read)
+          continue;
+        if (literal_marks[literal.neg()] == clauses_read)
+          skip_clause = true;
+        literal_marks[literal] = clauses_read;
+        literals.push_back(literal);
       }
       if (!skip_clause) {
         clauses_added++;
         add_clause(literals);
       }
     }
-    input_file.ignore(numeric_limits<streamsize>::max(), '\n');
+    input.skipLine();
+  }
+
+  for (auto &w : declarations.weights) {
+    if (static_cast<unsigned>(abs(w.first)) > nVars) {
+      cerr << "Invalid weight line: literal " << w.first << endl;
+      exit(1);
+    }
+    if (!set_literal_weight(LiteralID(w.first), w.second)) {
+      cerr << "Weight " << w.second << " of literal " << w.first
+           << " is not supported by the count type" << endl;
+      exit(1);
+    }
+  }
+
+  if (declarations.projected) {
+    vector<VariableIndex> projection;
+    for (auto var : declarations.projection) {
+      if (static_cast<unsigned>(var) > nVars) {
+        cerr << "Invalid projection line: variable " << var << endl;
+        exit(1);
+      }
+      projection.push_back(VariableIndex(var));
+    }
+    set_projection(projection);
   }
 
   // all done
@@ -404,4 +564,238 @@ bool Instance::createfromFile(const string &file_name) {
   return true;
 }
 
+
+// 64 bit FNV-1a hash
+static const uint64_t HASH_BASIS = 14695981039346656037ull;
+
+static void hashBytes(uint64_t &hash, const void *data, size_t size) {
+  auto bytes = static_cast<const unsigned char *>(data);
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+}
+
+static bool hashFile(const string &file_name, uint64_t &hash) {
+  ifstream file(file_name, ios::binary);
+  if (!file)
+    return false;
+  hash = HASH_BASIS;
+  vector<char> buffer(1 << 20);
+  while (file) {
+    file.read(buffer.data(), buffer.size());
+    hashBytes(hash, buffer.data(), static_cast<size_t>(file.gcount()));
+  }
+  return file.eof();
+}
+
+uint64_t Instance::fingerprint() {
+  uint64_t hash = HASH_BASIS;
+  hashBytes(hash, MODEL_COUNT_TYPE, strlen(MODEL_COUNT_TYPE));
+  uint64_t num_variables = variables_.size();
+  hashBytes(hash, &num_variables, sizeof(num_variables));
+  // clause headers are left out, they change during the search
+  auto pool_end = literal_pool_.begin() + original_lit_pool_size_;
+  for (auto it = literal_pool_.begin(); it != pool_end; it++) {
+    hashBytes(hash, &*it, sizeof(LiteralID));
+    if (*it == SENTINEL_LIT && it + 1 != pool_end)
+      it += ClauseHeader::overheadInLits();
+  }
+  for (auto l = LiteralID(VariableIndex(0), false); l != literals_.end_lit();
+      l.inc()) {
+    auto &links = literal(l).binary_links_;
+    hashBytes(hash, links.data(), links.size() * sizeof(LiteralID));
+    if (weighted()) {
+      string weight = literal_weights_[l].to_bytes();
+      hashBytes(hash, weight.data(), weight.size());
+    }
+  }
+  for (bool in_projection : projection_)
+    hashBytes(hash, &in_projection, sizeof(in_projection));
+  return hash;
+}
+
+// The snapshot holds the arrays of the formula in native byte order, so
+// its key names the build as well as the contents of the input file and
+// the options.
+static string snapshotKey(const string &input_file, const string &options) {
+  uint64_t input_hash = 0;
+  if (input_file.empty() || !hashFile(input_file, input_hash))
+    return "";
+  const uint32_t byte_order = 0x01020304;
+  ostringstream key;
+  key << "sharpSAT snapshot 1 " << MODEL_COUNT_TYPE << ' '
+      << static_cast<unsigned>(*reinterpret_cast<const uint8_t *>(&byte_order))
+      << ' ' << sizeof(LiteralID) << ' ' << sizeof(ClauseHeader) << ' '
+      << options << ' ' << hex << input_hash;
+  return key.str();
+}
+
+bool Instance::writeSnapshot(const string &snapshot_file,
+    const string &input_file, const string &options) {
+  string key = snapshotKey(input_file, options);
+  if (key.empty())
+    return false;
+  BinaryWriter out(snapshot_file);
+  out.writeString(key);
+
+  out.writeValue<uint64_t>(variables_.size());
+  out.writeArray(literal_pool_);
+  out.writeValue<uint64_t>(original_lit_pool_size_);
+  for (auto l = LiteralID(VariableIndex(0), false); l != literals_.end_lit();
+      l.inc()) {
+    out.writeArray(literal(l).binary_links_);
+    out.writeArray(literal(l).watch_list_);
+    out.writeValue(literal(l).activity_score_);
+    out.writeArray(occurrence_lists_[l]);
+  }
+  out.writeArray(unit_clauses_);
+
+  out.writeValue<uint8_t>(weighted());
+  if (weighted())
+    for (auto l = LiteralID(VariableIndex(0), false);
+        l != literals_.end_lit(); l.inc())
+      out.writeCount(literal_weights_[l]);
+  out.writeArray(vector<uint8_t>(projection_.begin(), projection_.end()));
+  out.writeCount(removed_variables_weight_);
+
+  for (auto count : {
+      statistics_.num_original_variables_,
+      statistics_.num_original_clauses_,
+      statistics_.num_original_binary_clauses_,
+      statistics_.num_original_unit_clauses_,
+      statistics_.num_variables_,
+      statistics_.num_used_variables_,
+      statistics_.num_free_variables_,
+      statistics_.num_long_clauses_,
+      statistics_.num_binary_clauses_,
+      statistics_.num_unit_clauses_ })
+    out.writeValue<uint64_t>(count);
+
+  if (!out.commit()) {
+    cerr << "Cannot write snapshot file: " << snapshot_file << endl;
+    return false;
+  }
+  return true;
+}
+
+bool Instance::readSnapshot(const string &snapshot_file,
+    const string &input_file, const string &options) {
+  string key = snapshotKey(input_file, options);
+  BinaryReader in;
+  if (key.empty() || !in.open(snapshot_file))
+    return false;
+  string snapshot_key;
+  if (!in.readString(snapshot_key) || snapshot_key != key)
+    return false;
+
+  // everything is read before anything is replaced
+  uint64_t num_variables;
+  vector<LiteralID> literal_pool;
+  uint64_t original_lit_pool_size;
+  if (!in.readValue(num_variables) || num_variables == 0
+      || num_variables > in.size()
+      || !in.readArray(literal_pool) || literal_pool.empty()
+      || !in.readValue(original_lit_pool_size))
+    return false;
+
+  LiteralIndexedVector<Literal> literals(num_variables);
+  LiteralIndexedVector<vector<ClauseOfs>> occurrence_lists(num_variables);
+  for (auto l = LiteralID(VariableIndex(0), false); l != literals.end_lit();
+      l.inc())
+    if (!in.readArray(literals[l].binary_links_)
+        || !in.readArray(literals[l].watch_list_)
+        || !in.readValue(literals[l].activity_score_)
+        || !in.readArray(occurrence_lists[l]))
+      return false;
+  vector<LiteralID> unit_clauses;
+  if (!in.readArray(unit_clauses))
+    return false;
+
+  uint8_t is_weighted;
+  LiteralIndexedVector<ModelCount> literal_weights;
+  if (!in.readValue(is_weighted))
+    return false;
+  if (is_weighted) {
+    literal_weights.resize(num_variables);
+    for (auto l = LiteralID(VariableIndex(0), false);
+        l != literal_weights.end_lit(); l.inc())
+      if (!in.readCount(literal_weights[l]))
+        return false;
+  }
+  vector<uint8_t> projection;
+  ModelCount removed_variables_weight;
+  uint64_t counts[10];
+  if (!in.readArray(projection) || !in.readCount(removed_variables_weight)
+      || !in.readValue(counts))
+    return false;
+
+  initialize(num_variables - 1, 0, 0);
+  literal_pool_.swap(literal_pool);
+  original_lit_pool_size_ = original_lit_pool_size;
+  literals_ = move(literals);
+  occurrence_lists_ = move(occurrence_lists);
+  unit_clauses_.swap(unit_clauses);
+  literal_weights_ = move(literal_weights);
+  projection_.assign(projection.begin(), projection.end());
+  removed_variables_weight_ = removed_variables_weight;
+
+  statistics_.num_original_variables_ = counts[0];
+  statistics_.num_original_clauses_ = counts[1];
+  statistics_.num_original_binary_clauses_ = counts[2];
+  statistics_.num_original_unit_clauses_ = counts[3];
+  statistics_.num_variables_ = counts[4];
+  statistics_.num_used_variables_ = counts[5];
+  statistics_.num_free_variables_ = counts[6];
+  statistics_.num_long_clauses_ = counts[7];
+  statistics_.num_binary_clauses_ = counts[8];
+  statistics_.num_unit_clauses_ = counts[9];
+  return true;
+}
+
+void Instance::writeSearchState(BinaryWriter &out) {
+  out.writeArray(literal_pool_);
+  for (auto l = LiteralID(VariableIndex(0), false); l != literals_.end_lit();
+      l.inc()) {
+    out.writeArray(literal(l).binary_links_);
+    out.writeArray(literal(l).watch_list_);
+    out.writeValue(literal(l).activity_score_);
+    out.writeValue(literal_values_[l]);
+  }
+  out.writeArray(conflict_clauses_);
+  out.writeArray(unit_clauses_);
+  out.writeArray(variables_);
+}
+
+bool Instance::readSearchState(BinaryReader &in) {
+  // everything is read before anything is replaced
+  vector<LiteralID> literal_pool;
+  if (!in.readArray(literal_pool)
+      || literal_pool.size() < original_lit_pool_size_)
+    return false;
+  LiteralIndexedVector<Literal> literals(variables_.size());
+  LiteralIndexedVector<TriValue> literal_values(variables_.size());
+  for (auto l = LiteralID(VariableIndex(0), false); l != literals.end_lit();
+      l.inc())
+    if (!in.readArray(literals[l].binary_links_)
+        || !in.readArray(literals[l].watch_list_)
+        || !in.readValue(literals[l].activity_score_)
+        || !in.readValue(literal_values[l]))
+      return false;
+  vector<ClauseOfs> conflict_clauses;
+  vector<LiteralID> unit_clauses;
+  vector<Variable> variables;
+  if (!in.readArray(conflict_clauses) || !in.readArray(unit_clauses)
+      || !in.readArray(variables) || variables.size() != variables_.size())
+    return false;
+
+  literal_pool_.swap(literal_pool);
+  literals_ = move(literals);
+  literal_values_ = move(literal_values);
+  conflict_clauses_.swap(conflict_clauses);
+  unit_clauses_.swap(unit_clauses);
+  variables_.swap(variables);
+  return true;
+}
+
 } // sharpSAT namespace
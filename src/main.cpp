@@ -1,5 +1,7 @@
 #include <sharpSAT/solver.h>
 
+#include <atomic>
+#include <csignal>
 #include <iostream>
 #include <vector>
 #include <string>
@@ -7,9 +9,20 @@
 using namespace std;
 using namespace sharpSAT;
 
+// set on SIGTERM or SIGINT, so that the search is saved to the checkpoint
+static atomic<bool> interrupt_requested(false);
+
+static void requestInterrupt(int) {
+  interrupt_requested = true;
+}
+
 int main(int argc, char *argv[]) {
 
   string input_file;
+  string assumptions_file;
+  string cube_dir;
+  unsigned split_depth = 0;
+  string merge_dir;
   Solver theSolver;
 
 
@@ -23,6 +36,19 @@ int main(int argc, char *argv[]) {
     cout << "\t -noCC  \t turn off component caching" << endl;
     cout << "\t -cs [n]\t set max cache size to n MB" << endl;
     cout << "\t -noIBCP\t turn off implicit BCP" << endl;
+    cout << "\t -p [n] \t count components on n threads" << endl;
+    cout << "\t -snap [file]\t load the preprocessed formula from file," << endl;
+    cout << "\t       \t or save it there" << endl;
+    cout << "\t -cf [file]\t load cached model counts from file," << endl;
+    cout << "\t       \t and save them there" << endl;
+    cout << "\t -assume [file]\t count under each set of literals in file" << endl;
+    cout << "\t -marg  \t also print the count with each literal true" << endl;
+    cout << "\t -nnf [file]\t write the search to file as decision-DNNF" << endl;
+    cout << "\t -split [n] [dir]\t split into cubes of n decisions," << endl;
+    cout << "\t       \t written to dir" << endl;
+    cout << "\t -merge [dir]\t sum the counts of the cubes in dir" << endl;
+    cout << "\t -ckpt [file]\t on timeout or SIGTERM save the search to file," << endl;
+    cout << "\t       \t and resume it from there" << endl;
     cout << "\t" << endl;
 
     return -1;
@@ -39,6 +65,8 @@ int main(int argc, char *argv[]) {
       theSolver.config().quiet = true;
     else if (strcmp(argv[i], "-v") == 0)
       theSolver.config().verbose = true;
+    else if (strcmp(argv[i], "-marg") == 0)
+      theSolver.config().compute_marginals = true;
     else if (strcmp(argv[i], "-t") == 0) {
       if (argc <= i + 1) {
         cout << " wrong parameters" << endl;
@@ -53,11 +81,73 @@ int main(int argc, char *argv[]) {
         return -1;
       }
       theSolver.statistics().maximum_cache_size_bytes_ = atol(argv[i + 1]) * (uint64_t) 1000000;
+    } else if (strcmp(argv[i], "-p") == 0) {
+      if (argc <= i + 1) {
+        cout << " wrong parameters" << endl;
+        return -1;
+      }
+      theSolver.config().num_threads = atol(argv[i + 1]);
+    } else if (strcmp(argv[i], "-snap") == 0) {
+      if (argc <= i + 1) {
+        cout << " wrong parameters" << endl;
+        return -1;
+      }
+      theSolver.config().snapshot_file = argv[i + 1];
+    } else if (strcmp(argv[i], "-cf") == 0) {
+      if (argc <= i + 1) {
+        cout << " wrong parameters" << endl;
+        return -1;
+      }
+      theSolver.config().cache_file = argv[i + 1];
+    } else if (strcmp(argv[i], "-ckpt") == 0) {
+      if (argc <= i + 1) {
+        cout << " wrong parameters" << endl;
+        return -1;
+      }
+      theSolver.config().checkpoint_file = argv[i + 1];
+    } else if (strcmp(argv[i], "-nnf") == 0) {
+      if (argc <= i + 1) {
+        cout << " wrong parameters" << endl;
+        return -1;
+      }
+      theSolver.config().nnf_file = argv[i + 1];
+    } else if (strcmp(argv[i], "-split") == 0) {
+      if (argc <= i + 2) {
+        cout << " wrong parameters" << endl;
+        return -1;
+      }
+      split_depth = atol(argv[i + 1]);
+      cube_dir = argv[i + 2];
+    } else if (strcmp(argv[i], "-merge") == 0) {
+      if (argc <= i + 1) {
+        cout << " wrong parameters" << endl;
+        return -1;
+      }
+      merge_dir = argv[i + 1];
+    } else if (strcmp(argv[i], "-assume") == 0) {
+      if (argc <= i + 1) {
+        cout << " wrong parameters" << endl;
+        return -1;
+      }
+      assumptions_file = argv[i + 1];
     } else
       input_file = argv[i];
   }
 
-  theSolver.load_and_solve(input_file);
+  if (!merge_dir.empty())
+    Solver::merge(merge_dir);
+  else if (!cube_dir.empty())
+    theSolver.load_and_split(input_file, split_depth, cube_dir);
+  else if (assumptions_file.empty()) {
+    // a preempted job saves its search like on timeout
+    if (!theSolver.config().checkpoint_file.empty()) {
+      theSolver.setInterrupt(&interrupt_requested);
+      signal(SIGTERM, requestInterrupt);
+      signal(SIGINT, requestInterrupt);
+    }
+    theSolver.load_and_solve(input_file);
+  } else
+    theSolver.load_and_count(input_file, assumptions_file);
 
 //  cout << sizeof(LiteralID)<<"MALLOC_STATS:" << endl;
 //  malloc_stats();
@@ -0,0 +1,108 @@
+/*
+ * marginal_stack.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <sharpSAT/marginal_stack.h>
+
+#include <cassert>
+
+using namespace std;
+
+namespace sharpSAT {
+
+void MarginalStack::includeComponent(const ModelCount &model_count,
+    const Component &comp, const vector<ModelCount> &marginals) {
+  assert(marginals.size() == 2 * comp.num_variables());
+  Level &top = levels_[depth_ - 1];
+  top.counts.push_back(model_count);
+  for (auto vt = comp.varsBegin(); vt->get<VariableIndex>() != varsSENTINEL;
+      vt++)
+    top.vars.push_back(vt->get<VariableIndex>());
+  top.ends.push_back(top.vars.size());
+  top.part_marginals.insert(top.part_marginals.end(), marginals.begin(),
+      marginals.end());
+}
+
+void MarginalStack::finishBranch(const Component &super_comp,
+    const ModelCount &branch_count,
+    const LiteralIndexedVector<TriValue> &literal_values,
+    const LiteralIndexedVector<ModelCount> &literal_weights) {
+  Level &top = levels_[depth_ - 1];
+  unsigned num_vars = super_comp.num_variables();
+  if (top.marginals.empty())
+    top.marginals.assign(2 * num_vars, ModelCount(0));
+  if (branch_count == 0) {
+    top.clearParts();
+    return;
+  }
+
+  unsigned pos = 0;
+  for (auto vt = super_comp.varsBegin();
+      vt->get<VariableIndex>() != varsSENTINEL; vt++)
+    position_[vt->get<VariableIndex>()] = pos++;
+  in_component_.assign(num_vars, false);
+  for (auto v : top.vars)
+    in_component_[position_[v]] = true;
+
+  // the literals set in the branch multiply its count by their weights
+  ModelCount assigned_weight = 1;
+  pos = 0;
+  for (auto vt = super_comp.varsBegin();
+      vt->get<VariableIndex>() != varsSENTINEL; vt++, pos++) {
+    VariableIndex v = vt->get<VariableIndex>();
+    LiteralID lit(v, true);
+    if (literal_values[lit] == TriValue::X_TRI) {
+      if (in_component_[pos])
+        continue;
+      // a free variable is a component of its own
+      top.vars.push_back(v);
+      top.ends.push_back(top.vars.size());
+      if (literal_weights.empty()) {
+        top.counts.push_back(2);
+        top.part_marginals.push_back(1);
+        top.part_marginals.push_back(1);
+      } else {
+        top.counts.push_back(literal_weights[lit] + literal_weights[lit.neg()]);
+        top.part_marginals.push_back(literal_weights[lit.neg()]);
+        top.part_marginals.push_back(literal_weights[lit]);
+      }
+      continue;
+    }
+    if (literal_values[lit] == TriValue::F_TRI)
+      lit = lit.neg();
+    top.marginals[2 * pos + lit.sign()] += branch_count;
+    if (!literal_weights.empty())
+      assigned_weight *= literal_weights[lit];
+  }
+
+  // the marginals of a component are multiplied by the counts of
+  // all other components, which are those before times those after it
+  unsigned num_comps = top.counts.size();
+  suffix_counts_.resize(num_comps + 1);
+  suffix_counts_[num_comps] = assigned_weight;
+  for (unsigned i = num_comps; i > 0; i--) {
+    suffix_counts_[i - 1] = suffix_counts_[i];
+    suffix_counts_[i - 1] *= top.counts[i - 1];
+  }
+  ModelCount prefix_count = 1;
+  unsigned begin = 0;
+  for (unsigned i = 0; i < num_comps; i++) {
+    ModelCount factor = prefix_count;
+    factor *= suffix_counts_[i + 1];
+    for (unsigned j = begin; j < top.ends[i]; j++) {
+      pos = position_[top.vars[j]];
+      for (unsigned sign = 0; sign < 2; sign++) {
+        ModelCount marginal = top.part_marginals[2 * j + sign];
+        marginal *= factor;
+        top.marginals[2 * pos + sign] += marginal;
+      }
+    }
+    prefix_count *= top.counts[i];
+    begin = top.ends[i];
+  }
+  top.clearParts();
+}
+
+} // sharpSAT namespace
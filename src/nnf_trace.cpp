@@ -0,0 +1,123 @@
+/*
+ * nnf_trace.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <sharpSAT/nnf_trace.h>
+
+#include <cassert>
+#include <cstdio>
+
+using namespace std;
+
+namespace sharpSAT {
+
+bool NnfTrace::open(const string &file_name, unsigned num_input_variables,
+    const VariableIndexedVector<VariableIndex> &input_variables) {
+  file_name_ = file_name;
+  tmp_file_name_ = file_name + ".tmp";
+  out_.open(tmp_file_name_);
+  if (!out_)
+    return false;
+  num_nodes_ = 0;
+  num_edges_ = 0;
+  num_input_variables_ = num_input_variables;
+  input_variables_ = input_variables;
+  literal_nodes_.clear();
+  literal_nodes_.resize(num_input_variables + 1, 0);
+  levels_.clear();
+  children_.clear();
+
+  writeNode("O 0 0", 0);
+  writeNode("A 0", 0);
+  return true;
+}
+
+bool NnfTrace::close(unsigned root) {
+  // the root has to be the last node
+  if (root != num_nodes_ - 1)
+    writeNode("A 1 " + to_string(root), 1);
+  out_.close();
+  bool written = !out_.fail();
+  if (written) {
+    ifstream body(tmp_file_name_);
+    ofstream out(file_name_);
+    out << "nnf " << num_nodes_ << ' ' << num_edges_ << ' '
+        << num_input_variables_ << '\n';
+    out << body.rdbuf();
+    out.close();
+    written = !out.fail();
+  }
+  remove(tmp_file_name_.c_str());
+  return written;
+}
+
+void NnfTrace::discard() {
+  out_.close();
+  remove(tmp_file_name_.c_str());
+}
+
+void NnfTrace::finishBranch(const Component &super_comp, bool active_branch,
+    bool found_unsat, const LiteralIndexedVector<TriValue> &literal_values) {
+  Level &top = levels_.back();
+  if (found_unsat) {
+    children_.resize(top.children_ofs);
+    top.branch_nodes[active_branch] = FALSE_NODE;
+    return;
+  }
+  for (auto vt = super_comp.varsBegin();
+      vt->get<VariableIndex>() != varsSENTINEL; vt++) {
+    LiteralID lit(vt->get<VariableIndex>(), true);
+    if (literal_values[lit] == TriValue::X_TRI)
+      continue;
+    if (literal_values[lit] == TriValue::F_TRI)
+      lit = lit.neg();
+    if (!input_variables_.empty())
+      lit = LiteralID(input_variables_[lit.var()], lit.sign());
+    includeNode(literalNode(lit));
+  }
+
+  unsigned num_children = children_.size() - top.children_ofs;
+  unsigned node;
+  if (num_children == 0)
+    node = TRUE_NODE;
+  else if (num_children == 1)
+    node = children_.back();
+  else {
+    string line = "A " + to_string(num_children);
+    for (unsigned i = top.children_ofs; i < children_.size(); i++)
+      line += ' ' + to_string(children_[i]);
+    node = writeNode(line, num_children);
+  }
+  children_.resize(top.children_ofs);
+  top.branch_nodes[active_branch] = node;
+}
+
+unsigned NnfTrace::pop(VariableIndex decision_var) {
+  assert(children_.size() == levels_.back().children_ofs);
+  unsigned *branch_nodes = levels_.back().branch_nodes;
+  unsigned node;
+  if (branch_nodes[0] == FALSE_NODE)
+    node = branch_nodes[1];
+  else if (branch_nodes[1] == FALSE_NODE)
+    node = branch_nodes[0];
+  else {
+    if (!input_variables_.empty())
+      decision_var = input_variables_[decision_var];
+    node = writeNode("O " + to_string(static_cast<unsigned>(decision_var))
+        + " 2 " + to_string(branch_nodes[0]) + ' '
+        + to_string(branch_nodes[1]), 2);
+  }
+  levels_.pop_back();
+  return node;
+}
+
+unsigned NnfTrace::literalNode(LiteralID input_lit) {
+  unsigned &node = literal_nodes_[input_lit];
+  if (node == 0)
+    node = writeNode("L " + to_string(input_lit.toInt()), 0);
+  return node;
+}
+
+} // sharpSAT namespace
@@ -0,0 +1,130 @@
+/*
+ * parallel_counter.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <sharpSAT/parallel_counter.h>
+#include <sharpSAT/solver.h>
+
+#include <chrono>
+
+using namespace std;
+
+namespace sharpSAT {
+
+void ComponentBatch::deliver(unsigned slot, bool counted,
+    const ModelCount &count) {
+  lock_guard<mutex> lock(mutex_);
+  assert(num_pending_ > 0);
+  if (counted) {
+    counts_[slot] = count;
+    if (count == 0)
+      found_unsat_ = true;
+  } else
+    failed_ = true;
+  if (--num_pending_ == 0)
+    all_delivered_.notify_all();
+}
+
+bool ComponentBatch::waitFor(unsigned milliseconds) {
+  unique_lock<mutex> lock(mutex_);
+  return all_delivered_.wait_for(lock, chrono::milliseconds(milliseconds),
+      [this] { return num_pending_ == 0; });
+}
+
+ParallelComponentCounter::ParallelComponentCounter(const Instance &formula,
+    const SolverConfiguration &config, uint64_t cache_bytes,
+    SharedComponentCache &shared_cache) :
+    formula_(formula), config_(config), cache_bytes_(cache_bytes),
+    shared_cache_(shared_cache) {
+  // workers count sequentially and silently,
+  // the dispatching solver keeps track of the time bound
+  config_.num_threads = 1;
+  config_.time_bound_seconds = 0;
+  config_.verbose = false;
+  config_.quiet = true;
+  config_.snapshot_file.clear();
+  config_.cache_file.clear();
+
+  for (unsigned i = 0; i < config.num_threads; i++)
+    deques_.emplace_back(new WorkStealingDeque<ComponentTask>());
+  for (unsigned i = 0; i < config.num_threads; i++)
+    workers_.emplace_back(&ParallelComponentCounter::work, this, i);
+}
+
+ParallelComponentCounter::~ParallelComponentCounter() {
+  {
+    lock_guard<mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  work_available_.notify_all();
+  for (auto &worker : workers_)
+    worker.join();
+}
+
+shared_ptr<ComponentBatch> ParallelComponentCounter::dispatch(
+    const vector<LiteralID> &assignment, vector<Component> &&components) {
+  auto batch = make_shared<ComponentBatch>(components.size());
+  auto shared_assignment = make_shared<const vector<LiteralID>>(assignment);
+
+  for (unsigned slot = 0; slot < components.size(); slot++) {
+    ComponentTask task;
+    task.batch = batch;
+    task.slot = slot;
+    task.assignment = shared_assignment;
+    task.component = move(components[slot]);
+    deques_[next_deque_]->push(move(task));
+    next_deque_ = (next_deque_ + 1) % deques_.size();
+  }
+  {
+    lock_guard<mutex> lock(mutex_);
+    num_queued_ += components.size();
+  }
+  work_available_.notify_all();
+  return batch;
+}
+
+bool ParallelComponentCounter::fetchTask(unsigned worker_id,
+    ComponentTask &task) {
+  if (deques_[worker_id]->pop(task))
+    return true;
+  for (unsigned i = 1; i < deques_.size(); i++)
+    if (deques_[(worker_id + i) % deques_.size()]->steal(task))
+      return true;
+  return false;
+}
+
+void ParallelComponentCounter::work(unsigned worker_id) {
+  ComponentTask task;
+  while (true) {
+    if (fetchTask(worker_id, task)) {
+      num_queued_--;
+      count(task);
+      task = ComponentTask();
+      continue;
+    }
+    unique_lock<mutex> lock(mutex_);
+    work_available_.wait(lock,
+        [this] { return shutdown_ || num_queued_ > 0; });
+    if (shutdown_)
+      return;
+  }
+}
+
+void ParallelComponentCounter::count(ComponentTask &task) {
+  ModelCount model_count;
+  bool counted = false;
+  if (!task.batch->cancelled()) {
+    Solver solver(formula_);
+    solver.config() = config_;
+    solver.setTimeBound(config_.time_bound_seconds);
+    solver.statistics().maximum_cache_size_bytes_ = cache_bytes_;
+    solver.setSharedCache(&shared_cache_);
+    counted = solver.countComponent(*task.assignment, task.component,
+        &task.batch->cancelled(), model_count);
+  }
+  task.batch->deliver(task.slot, counted, model_count);
+}
+
+} // sharpSAT namespace
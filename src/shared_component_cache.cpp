@@ -0,0 +1,124 @@
+/*
+ * shared_component_cache.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <sharpSAT/shared_component_cache.h>
+
+#include <algorithm>
+
+using namespace std;
+
+namespace sharpSAT {
+
+SharedComponentCache::SharedComponentCache(uint64_t maximum_cache_size_bytes,
+    SharedCacheStatistics &statistics) :
+    shards_(new Shard[1 << num_shard_bits_]),
+    maximum_shard_size_bytes_(maximum_cache_size_bytes >> num_shard_bits_),
+    statistics_(statistics) {
+  for (unsigned s = 0; s < (1u << num_shard_bits_); s++) {
+    shards_[s].entry_base.resize(1);
+    shards_[s].table.resize(1024, 0);
+  }
+}
+
+unsigned SharedComponentCache::find(Shard &shard,
+    const CacheableComponent &packed_comp) {
+  unsigned act_id = shard.table[packed_comp.hashkey() & (shard.table.size() - 1)];
+  while (act_id) {
+    const Entry &entry = shard.entry_base[act_id];
+    if (entry.hashkey == packed_comp.hashkey()
+        && entry.data.size() == packed_comp.data_size()
+        && equal(entry.data.begin(), entry.data.end(), packed_comp.data()))
+      return act_id;
+    act_id = entry.next_bucket_element;
+  }
+  return 0;
+}
+
+bool SharedComponentCache::lookUp(const CacheableComponent &packed_comp,
+    ModelCount &model_count) {
+  statistics_.num_look_ups_++;
+  Shard &shard = shardOf(packed_comp.hashkey());
+  lock_guard<mutex> lock(shard.mutex);
+  unsigned id = find(shard, packed_comp);
+  if (id == 0)
+    return false;
+  statistics_.num_hits_++;
+  model_count = shard.entry_base[id].model_count;
+  return true;
+}
+
+void SharedComponentCache::store(const CacheableComponent &packed_comp,
+    const ModelCount &model_count) {
+  Shard &shard = shardOf(packed_comp.hashkey());
+  lock_guard<mutex> lock(shard.mutex);
+  // another thread might have counted the component as well
+  if (find(shard, packed_comp))
+    return;
+
+  if (shard.bytes_memory_usage >= maximum_shard_size_bytes_)
+    deleteEntries(shard);
+  if (shard.entry_base.size() >= shard.table.size())
+    reHashTable(shard, 2 * shard.table.size());
+
+  unsigned id;
+  if (shard.free_entry_base_slots.empty()) {
+    shard.entry_base.emplace_back();
+    id = shard.entry_base.size() - 1;
+  } else {
+    id = shard.free_entry_base_slots.back();
+    shard.free_entry_base_slots.pop_back();
+  }
+  Entry &entry = shard.entry_base[id];
+  entry.data.assign(packed_comp.data(),
+      packed_comp.data() + packed_comp.data_size());
+  entry.hashkey = packed_comp.hashkey();
+  entry.creation_time = shard.time++;
+  entry.model_count = model_count;
+
+  unsigned table_ofs = entry.hashkey & (shard.table.size() - 1);
+  entry.next_bucket_element = shard.table[table_ofs];
+  shard.table[table_ofs] = id;
+
+  shard.bytes_memory_usage += entry.SizeInBytes();
+  statistics_.bytes_memory_usage_ += entry.SizeInBytes();
+  statistics_.num_stores_++;
+}
+
+void SharedComponentCache::reHashTable(Shard &shard, unsigned size) {
+  shard.table.assign(size, 0);
+  for (unsigned id = 1; id < shard.entry_base.size(); id++) {
+    Entry &entry = shard.entry_base[id];
+    if (entry.data.empty())
+      continue;
+    unsigned table_ofs = entry.hashkey & (size - 1);
+    entry.next_bucket_element = shard.table[table_ofs];
+    shard.table[table_ofs] = id;
+  }
+}
+
+void SharedComponentCache::deleteEntries(Shard &shard) {
+  // as in ComponentCache, the older half of the entries is removed
+  vector<unsigned> times;
+  for (unsigned id = 1; id < shard.entry_base.size(); id++)
+    if (!shard.entry_base[id].data.empty())
+      times.push_back(shard.entry_base[id].creation_time);
+  if (times.empty())
+    return;
+  nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+  unsigned cutoff = times[times.size() / 2];
+
+  for (unsigned id = 1; id < shard.entry_base.size(); id++) {
+    Entry &entry = shard.entry_base[id];
+    if (entry.data.empty() || entry.creation_time > cutoff)
+      continue;
+    shard.bytes_memory_usage -= entry.SizeInBytes();
+    statistics_.bytes_memory_usage_ -= entry.SizeInBytes();
+    entry = Entry();
+    shard.free_entry_base_slots.push_back(id);
+  }
+  reHashTable(shard, shard.table.size());
+}
+} // sharpSAT namespace
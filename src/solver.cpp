@@ -5,9 +5,16 @@
  *      Author: marc
  */
 #include <sharpSAT/solver.h>
+#include <sharpSAT/binary_file.h>
+#include <sharpSAT/input_buffer.h>
+
 #include <algorithm>
+#include <cstdio>
+#include <cstdlib>
 #include <deque>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 #include <tuple>
 
 using namespace std;
@@ -89,7 +96,7 @@ bool Solver::prepFailedLiteralTest() {
 
 void Solver::HardWireAndCompact() {
 	compactClauses();
-	compactVariables();
+	compactVariables(keepFreeVariables());
 	literal_stack_.clear();
 
 	for (auto l = LiteralID(VariableIndex(1), false); l != literals_.end_lit(); l.inc()) {
@@ -108,15 +115,26 @@ void Solver::HardWireAndCompact() {
 
 void Solver::solve() {
 	initStack(num_variables());
+	literal_counts_.clear();
 
 	if (config_.verbose) {
 		statistics_.printShortFormulaInfo();
 	}
-	if (config_.verbose)
-		cout << endl << "Preprocessing .." << flush;
-	bool notfoundUNSAT = simplePreProcess();
-	if (config_.verbose)
-		cout << " DONE" << endl;
+	bool notfoundUNSAT = true;
+	if (from_snapshot_) {
+		if (config_.verbose)
+			cout << endl << "Preprocessed formula loaded from "
+					<< config_.snapshot_file << endl;
+	} else {
+		if (config_.verbose)
+			cout << endl << "Preprocessing .." << flush;
+		notfoundUNSAT = simplePreProcess();
+		if (config_.verbose)
+			cout << " DONE" << endl;
+		if (notfoundUNSAT && usesSnapshot())
+			writeSnapshot(config_.snapshot_file, statistics_.input_file_,
+					snapshotOptions());
+	}
 
 	if (notfoundUNSAT) {
 
@@ -129,16 +147,106 @@ void Solver::solve() {
 
 		violated_clause.reserve(num_variables());
 
+		if (!config_.cache_file.empty() || checkpointing())
+			formula_fingerprint_ = fingerprint();
+		if (!config_.cache_file.empty())
+			comp_manager_.setFormulaFingerprint(formula_fingerprint_);
 		comp_manager_.initialize(literals_, literal_pool_);
 
+		if (!config_.checkpoint_file.empty() && !checkpointing())
+			cerr << "Checkpoints of marginals and NNF traces are not supported"
+					<< endl;
+		else if (checkpointing() && readCheckpoint() && config_.verbose)
+			cout << "Search resumed from " << config_.checkpoint_file << endl;
+
+		if (config_.compute_marginals && projected())
+			cerr << "Marginals of projected counts are not supported" << endl;
+		else if (config_.compute_marginals) {
+			marginal_stack_.reset(new MarginalStack(num_variables()));
+			comp_manager_.setMarginalStack(marginal_stack_.get());
+		}
+		if (!config_.nnf_file.empty() && projected())
+			cerr << "The NNF trace of projected counts is not supported" << endl;
+		else if (!config_.nnf_file.empty())
+			startNnfTrace();
+
+		// the marginals, the NNF trace and checkpoints
+		// need a sequential search
+		if (config_.num_threads > 1 && !marginal_stack_ && !nnf_trace_
+				&& !checkpointing()) {
+			// half of the cache budget goes to the shared cache,
+			// the other half is split evenly among all solvers
+			uint64_t shared_cache_bytes = statistics_.maximum_cache_size_bytes_ / 2;
+			uint64_t cache_bytes = (statistics_.maximum_cache_size_bytes_
+					- shared_cache_bytes) / (config_.num_threads + 1);
+			statistics_.shared_cache_statistics_ =
+					make_shared<SharedCacheStatistics>();
+			shared_cache_.reset(new SharedComponentCache(shared_cache_bytes,
+					*statistics_.shared_cache_statistics_));
+			parallel_counter_.reset(new ParallelComponentCounter(
+					static_cast<const Instance &>(*this), config_, cache_bytes,
+					*shared_cache_));
+			statistics_.maximum_cache_size_bytes_ = cache_bytes;
+			comp_manager_.setSharedCache(shared_cache_.get());
+		}
+
 		statistics_.exit_state_ = countSAT();
 
-		statistics_.set_final_solution_count(stack_.top().getTotalModelCount());
+		if (statistics_.exit_state_ == SOLVER_StateT::SUCCESS
+				&& !config_.cache_file.empty()
+				&& !comp_manager_.saveCachedModelCounts())
+			cerr << "Cannot write cache file: " << config_.cache_file << endl;
+
+		if (checkpointing()) {
+			if (statistics_.exit_state_ == SOLVER_StateT::SUCCESS)
+				remove(config_.checkpoint_file.c_str());
+			else if (!writeCheckpoint())
+				cerr << "Cannot write checkpoint file: "
+						<< config_.checkpoint_file << endl;
+			else if (config_.verbose)
+				cout << endl << "Search saved to " << config_.checkpoint_file
+						<< endl;
+		}
+
+		cancelDispatchedComponents();
+		parallel_counter_.reset();
+		comp_manager_.setSharedCache(nullptr);
+		shared_cache_.reset();
+
+		if (weighted() || projected()) {
+			ModelCount count = stack_.top().getTotalModelCount();
+			count *= removed_variables_weight_;
+			statistics_.set_final_weighted_solution_count(count);
+		} else
+			statistics_.set_final_solution_count(stack_.top().getTotalModelCount());
 		statistics_.num_long_conflict_clauses_ = num_conflict_clauses();
 
+		if (marginal_stack_
+				&& statistics_.exit_state_ == SOLVER_StateT::SUCCESS)
+			setLiteralCounts(marginal_stack_->marginals());
+		comp_manager_.setMarginalStack(nullptr);
+		marginal_stack_.reset();
+
+		if (nnf_trace_) {
+			if (statistics_.exit_state_ != SOLVER_StateT::SUCCESS)
+				nnf_trace_->discard();
+			else if (!nnf_trace_->close(nnf_trace_->rootNode()))
+				cerr << "Cannot write NNF file: " << config_.nnf_file << endl;
+			comp_manager_.setNnfTrace(nullptr);
+			nnf_trace_.reset();
+		}
+
 	} else {
 		statistics_.exit_state_ = SOLVER_StateT::SUCCESS;
-		statistics_.set_final_solution_count(0.0);
+		statistics_.set_final_solution_count(0);
+		if (config_.compute_marginals && !projected())
+			literal_counts_.resize(num_variables() + 1, ModelCount(0));
+		NnfTrace nnf_trace;
+		if (!config_.nnf_file.empty() && !projected()
+				&& (!nnf_trace.open(config_.nnf_file, num_variables(),
+						VariableIndexedVector<VariableIndex>())
+						|| !nnf_trace.close(NnfTrace::FALSE_NODE)))
+			cerr << "Cannot write NNF file: " << config_.nnf_file << endl;
 		if (config_.verbose) {
 			cout << endl << " FOUND UNSAT DURING PREPROCESSING " << endl;
 		}
@@ -149,7 +257,10 @@ void Solver::load_and_solve(const string &file_name) {
 	stopwatch_.start();
 	statistics_.input_file_ = file_name;
 
-	createfromFile(file_name);
+	from_snapshot_ = usesSnapshot()
+			&& readSnapshot(config_.snapshot_file, file_name, snapshotOptions());
+	if (!from_snapshot_)
+		createfromFile(file_name);
 
 	if (config_.verbose) {
 		cout << "Solving " << file_name << endl;
@@ -168,6 +279,443 @@ void Solver::load_and_solve(const string &file_name) {
 		statistics_.print_final_solution_count();
 		cout << endl;
 	}
+	if (!config_.quiet && !literal_counts_.empty())
+		for (unsigned v = 1; 2 * v < literal_counts_.size(); v++)
+			for (int lit : {static_cast<int>(v), -static_cast<int>(v)})
+				cout << lit << " " << literal_counts_[LiteralID(lit)].get_str()
+						<< endl;
+}
+
+VariableIndexedVector<VariableIndex> Solver::inputVariables() {
+	VariableIndexedVector<VariableIndex> input_variables;
+	if (!compacted_variables_.empty()) {
+		input_variables.resize(num_variables() + 1);
+		for (VariableIndex v(1); v < VariableIndex(compacted_variables_.size());
+				++v)
+			if (compacted_variables_[v] != VariableIndex(0))
+				input_variables[compacted_variables_[v]] = v;
+	}
+	return input_variables;
+}
+
+void Solver::startNnfTrace() {
+	// the variables of the formula as loaded
+	unsigned num_vars = compacted_variables_.empty() ?
+			num_variables() : compacted_variables_.size() - 1;
+	nnf_trace_.reset(new NnfTrace());
+	if (!nnf_trace_->open(config_.nnf_file, num_vars, inputVariables())) {
+		cerr << "Cannot write NNF file: " << config_.nnf_file << endl;
+		nnf_trace_.reset();
+		return;
+	}
+	nnf_trace_->push();
+	for (VariableIndex v(1); v <= VariableIndex(num_vars); ++v)
+		if (!compacted_variables_.empty()
+				&& compacted_variables_[v] == VariableIndex(0)) {
+			LiteralID lit(v, true);
+			nnf_trace_->includeLiteral(
+					input_literal_values_[lit] == TriValue::T_TRI ? lit : lit.neg());
+		}
+	comp_manager_.setNnfTrace(nnf_trace_.get());
+}
+
+void Solver::setLiteralCounts(const vector<ModelCount> &marginals) {
+	// the variables of the formula as loaded
+	unsigned num_vars = compacted_variables_.empty() ?
+			num_variables() : compacted_variables_.size() - 1;
+	literal_counts_.clear();
+	literal_counts_.resize(num_vars + 1, ModelCount(0));
+	for (VariableIndex v(1); v <= VariableIndex(num_vars); ++v) {
+		VariableIndex compacted_v = compacted_variables_.empty() ?
+				v : compacted_variables_[v];
+		for (bool sign : {false, true}) {
+			LiteralID lit(v, sign);
+			ModelCount &count = literal_counts_[lit];
+			if (compacted_v == VariableIndex(0)) {
+				// removed by preprocessing, hence assigned
+				if (input_literal_values_[lit] == TriValue::T_TRI)
+					count = statistics_.final_solution_count();
+				continue;
+			}
+			count = marginals[2 * (static_cast<unsigned>(compacted_v) - 1) + sign];
+			if (weighted())
+				count *= removed_variables_weight_;
+			else
+				count.mul_2exp(statistics_.num_variables_
+						- statistics_.num_used_variables_);
+		}
+	}
+}
+
+bool Solver::count(const vector<LiteralID> &assumptions, ModelCount &count) {
+	stopwatch_.start();
+	if (!counting_assumptions_) {
+		counting_assumptions_ = true;
+		initStack(num_variables());
+		formula_unsat_ = !simplePreProcess();
+		// conflict clauses may depend on the assumptions,
+		// so each count starts from the preprocessed clauses
+		saveClauses();
+		violated_clause.reserve(num_variables());
+	} else {
+		for (auto lit : literal_stack_)
+			unSet(lit);
+		restoreClauses();
+		initStack(num_variables());
+	}
+
+	vector<LiteralID> lits;
+	bool consistent = !formula_unsat_ && compactedLiterals(assumptions, lits);
+	// unit clauses are left only if preprocessing is turned off
+	lits.insert(lits.end(), unit_clauses_.begin(), unit_clauses_.end());
+	for (auto lit : lits)
+		if (isResolved(lit))
+			consistent = false;
+		else
+			setLiteralIfFree(lit);
+	consistent = consistent && BCP(0);
+
+	ModelCount total = 0;
+	statistics_.exit_state_ = SOLVER_StateT::SUCCESS;
+	if (consistent) {
+		last_ccl_deletion_time_ = last_ccl_cleanup_time_ =
+				statistics_.num_clauses_learned_;
+		if (cache_reusable_)
+			comp_manager_.reinitialize();
+		else
+			comp_manager_.initialize(literals_, literal_pool_);
+
+		statistics_.exit_state_ = countSAT();
+		// a search given up may leave counts in the cache
+		// which are polluted by an unsatisfiable branch
+		cache_reusable_ = statistics_.exit_state_ == SOLVER_StateT::SUCCESS;
+		total = stack_.top().getTotalModelCount();
+	}
+
+	if (weighted() || projected()) {
+		total *= removed_variables_weight_;
+		statistics_.set_final_weighted_solution_count(total);
+	} else
+		statistics_.set_final_solution_count(total);
+	stopwatch_.stop();
+	statistics_.time_elapsed_ = stopwatch_.getElapsedSeconds();
+	count = statistics_.final_solution_count();
+	return statistics_.exit_state_ == SOLVER_StateT::SUCCESS;
+}
+
+void Solver::load_and_count(const string &file_name,
+		const string &assumptions_file) {
+	statistics_.input_file_ = file_name;
+	createfromFile(file_name);
+	int num_input_variables = num_variables();
+
+	InputBuffer input;
+	if (!input.open(assumptions_file)) {
+		cerr << "Cannot open file: " << assumptions_file << endl;
+		return;
+	}
+	if (config_.verbose)
+		cout << "Counting " << file_name << " under the assumptions in "
+				<< assumptions_file << endl;
+
+	vector<LiteralID> assumptions;
+	ModelCount model_count;
+	int lit;
+	while (char c = input.peekNonSpace()) {
+		if (c == 'c') {
+			input.skipLine();
+			continue;
+		}
+		if (!input.readInt(lit) || abs(lit) > num_input_variables) {
+			cerr << "Invalid assumptions file" << endl;
+			return;
+		}
+		if (lit != 0) {
+			assumptions.push_back(LiteralID(lit));
+			continue;
+		}
+		count(assumptions, model_count);
+		if (!config_.quiet) {
+			statistics_.print_final_solution_count();
+			cout << endl;
+		}
+		assumptions.clear();
+	}
+}
+
+void Solver::split(unsigned depth, vector<vector<LiteralID>> &cubes) {
+	cubes.clear();
+	splitting_ = true;
+	initStack(num_variables());
+	bool consistent = simplePreProcess();
+	splitting_ = false;
+	violated_clause.reserve(num_variables());
+	// unit clauses are left only if preprocessing is turned off
+	for (auto lit : unit_clauses_)
+		if (isResolved(lit))
+			consistent = false;
+		else
+			setLiteralIfFree(lit);
+	if (!consistent || !BCP(0))
+		return;
+
+	vector<LiteralID> cube;
+	splitBelow(depth, cube, cubes);
+
+	VariableIndexedVector<VariableIndex> input_variables = inputVariables();
+	if (!input_variables.empty())
+		for (auto &c : cubes)
+			for (auto &lit : c)
+				lit = LiteralID(input_variables[lit.var()], lit.sign());
+}
+
+void Solver::splitBelow(unsigned depth, vector<LiteralID> &cube,
+		vector<vector<LiteralID>> &cubes) {
+	unsigned max_score = 0;
+	VariableIndex max_score_var(0);
+	// branching on other variables than projection variables
+	// would count some projected models in several cubes
+	if (depth > 0)
+		for (VariableIndex v(1); v <= VariableIndex(num_variables()); ++v) {
+			LiteralID lit(v, true);
+			if (!isActive(lit) || !inProjection(v))
+				continue;
+			unsigned score = occurrencesOf(lit) + occurrencesOf(lit.neg());
+			if (score > max_score) {
+				max_score = score;
+				max_score_var = v;
+			}
+		}
+	if (max_score_var == VariableIndex(0)) {
+		cubes.push_back(cube);
+		return;
+	}
+
+	LiteralID lit(max_score_var, occurrencesOf(LiteralID(max_score_var, true))
+			> occurrencesOf(LiteralID(max_score_var, false)));
+	for (auto branch_lit : {lit, lit.neg()}) {
+		size_t sz = literal_stack_.size();
+		setLiteralIfFree(branch_lit);
+		cube.push_back(branch_lit);
+		if (BCP(sz))
+			splitBelow(depth - 1, cube, cubes);
+		cube.pop_back();
+		while (literal_stack_.size() > sz) {
+			unSet(literal_stack_.back());
+			literal_stack_.pop_back();
+		}
+	}
+}
+
+// copies input_file to cube_file, with the literals of cube
+// as unit clauses following the problem line
+static bool writeCubeFile(const string &input_file,
+		const vector<LiteralID> &cube, const string &cube_file) {
+	InputBuffer input;
+	if (!input.open(input_file))
+		return false;
+	ofstream out(cube_file);
+	bool problem_line_read = false;
+	while (input.peekNonSpace()) {
+		string line = input.readLine();
+		unsigned num_vars, num_clauses;
+		string p, cnf;
+		istringstream problem_line(line);
+		if (problem_line_read || line[0] != 'p'
+				|| !(problem_line >> p >> cnf >> num_vars >> num_clauses)) {
+			out << line << '\n';
+			continue;
+		}
+		problem_line_read = true;
+		out << "p cnf " << num_vars << ' ' << num_clauses + cube.size() << '\n';
+		for (auto lit : cube)
+			out << lit.toInt() << " 0\n";
+	}
+	out.close();
+	return problem_line_read && !out.fail();
+}
+
+void Solver::load_and_split(const string &file_name, unsigned depth,
+		const string &dir) {
+	statistics_.input_file_ = file_name;
+	createfromFile(file_name);
+
+	vector<vector<LiteralID>> cubes;
+	split(depth, cubes);
+
+	string cubes_file = dir + "/cubes";
+	ofstream out(cubes_file);
+	for (auto &cube : cubes) {
+		for (auto lit : cube)
+			out << lit.toInt() << ' ';
+		out << "0\n";
+	}
+	out.close();
+	if (out.fail()) {
+		cerr << "Cannot write file: " << cubes_file << endl;
+		return;
+	}
+	for (unsigned i = 0; i < cubes.size(); i++) {
+		string cube_file = dir + "/cube_" + to_string(i + 1) + ".cnf";
+		if (!writeCubeFile(file_name, cubes[i], cube_file)) {
+			cerr << "Cannot write file: " << cube_file << endl;
+			return;
+		}
+	}
+	if (!config_.quiet)
+		cout << cubes.size() << " cubes written to " << dir << endl;
+}
+
+void Solver::merge(const string &dir) {
+	string cubes_file = dir + "/cubes";
+	InputBuffer cubes;
+	if (!cubes.open(cubes_file)) {
+		cerr << "Cannot open file: " << cubes_file << endl;
+		return;
+	}
+	unsigned num_cubes = 0;
+	int lit;
+	while (char c = cubes.peekNonSpace()) {
+		if (c == 'c') {
+			cubes.skipLine();
+			continue;
+		}
+		if (!cubes.readInt(lit)) {
+			cerr << "Invalid cubes file" << endl;
+			return;
+		}
+		if (lit == 0)
+			num_cubes++;
+	}
+
+	ModelCount total = 0;
+	for (unsigned i = 1; i <= num_cubes; i++) {
+		string result_file = dir + "/cube_" + to_string(i) + ".txt";
+		InputBuffer result;
+		if (!result.open(result_file)) {
+			cerr << "Cannot open file: " << result_file << endl;
+			return;
+		}
+		string count_str;
+		ModelCount count;
+		if (!result.peekNonSpace()
+				|| !(istringstream(result.readLine()) >> count_str)
+				|| !ModelCount::from_str(count_str, count)) {
+			cerr << "No model count in file: " << result_file << endl;
+			return;
+		}
+		total += count;
+	}
+	cout << total.get_str() << endl;
+}
+
+string Solver::checkpointKey() const {
+	const uint32_t byte_order = 0x01020304;
+	ostringstream key;
+	key << "sharpSAT checkpoint 1 " << MODEL_COUNT_TYPE << ' '
+			<< static_cast<unsigned>(*reinterpret_cast<const uint8_t *>(&byte_order))
+			<< ' ' << sizeof(LiteralID) << ' ' << sizeof(ClauseHeader) << ' '
+			<< sizeof(unsigned) << ' ' << hex << formula_fingerprint_;
+	return key.str();
+}
+
+bool Solver::writeCheckpoint() {
+	BinaryWriter out(config_.checkpoint_file);
+	out.writeString(checkpointKey());
+	writeSearchState(out);
+	writeDecisionStack(out);
+	comp_manager_.writeSearchState(out);
+	return out.commit();
+}
+
+bool Solver::readCheckpoint() {
+	BinaryReader in;
+	string key;
+	if (!in.open(config_.checkpoint_file) || !in.readString(key)
+			|| key != checkpointKey())
+		return false;
+	// the search state is replaced while it is read
+	if (!readSearchState(in) || !readDecisionStack(in)
+			|| !comp_manager_.readSearchState(in)) {
+		cerr << "Invalid checkpoint file: " << config_.checkpoint_file << endl;
+		exit(1);
+	}
+	return true;
+}
+
+void Solver::writeDecisionStack(BinaryWriter &out) {
+	out.writeArray(literal_stack_);
+	out.writeValue<uint64_t>(stack_.size());
+	for (auto &level : stack_) {
+		unsigned offsets[4] = { level.super_component(),
+				level.literal_stack_ofs(), level.remaining_components_ofs(),
+				level.unprocessed_components_end() };
+		out.writeValue(offsets);
+		out.writeValue<uint8_t>(level.isSecondBranch());
+		for (unsigned branch : { 0, 1 }) {
+			out.writeCount(level.branch_model_count(branch));
+			out.writeValue<uint8_t>(level.branch_found_unsat(branch));
+		}
+	}
+	uint64_t counts[] = {
+			last_ccl_deletion_time_,
+			last_ccl_cleanup_time_,
+			statistics_.num_decisions_,
+			statistics_.num_conflicts_,
+			statistics_.num_clauses_learned_,
+			statistics_.times_conflict_clauses_cleaned_,
+			statistics_.num_failed_literals_detected_,
+			statistics_.num_failed_literal_tests_,
+			statistics_.num_unit_clauses_,
+			statistics_.num_binary_conflict_clauses_,
+			statistics_.num_cache_look_ups_,
+			statistics_.num_cache_hits_,
+			statistics_.sum_cache_hit_sizes_ };
+	out.writeValue(counts);
+}
+
+bool Solver::readDecisionStack(BinaryReader &in) {
+	uint64_t num_levels;
+	if (!in.readArray(literal_stack_) || !in.readValue(num_levels)
+			|| num_levels == 0 || num_levels > in.size())
+		return false;
+	stack_.clear();
+	for (uint64_t u = 0; u < num_levels; u++) {
+		unsigned offsets[4];
+		uint8_t second_branch;
+		if (!in.readValue(offsets) || !in.readValue(second_branch)
+				|| offsets[0] >= offsets[2] || offsets[3] < offsets[2]
+				|| offsets[1] > literal_stack_.size())
+			return false;
+		stack_.push_back(StackLevel(offsets[0], offsets[1], offsets[2]));
+		stack_.top().set_unprocessed_components_end(offsets[3]);
+		if (second_branch)
+			stack_.top().changeBranch();
+		for (unsigned branch : { 0, 1 }) {
+			ModelCount model_count;
+			uint8_t found_unsat;
+			if (!in.readCount(model_count) || !in.readValue(found_unsat))
+				return false;
+			stack_.top().set_branch(branch, model_count, found_unsat);
+		}
+	}
+	uint64_t counts[13];
+	if (!in.readValue(counts))
+		return false;
+	last_ccl_deletion_time_ = counts[0];
+	last_ccl_cleanup_time_ = counts[1];
+	statistics_.num_decisions_ = counts[2];
+	statistics_.num_conflicts_ = counts[3];
+	statistics_.num_clauses_learned_ = counts[4];
+	statistics_.times_conflict_clauses_cleaned_ = counts[5];
+	statistics_.num_failed_literals_detected_ = counts[6];
+	statistics_.num_failed_literal_tests_ = counts[7];
+	statistics_.num_unit_clauses_ = counts[8];
+	statistics_.num_binary_conflict_clauses_ = counts[9];
+	statistics_.num_cache_look_ups_ = counts[10];
+	statistics_.num_cache_hits_ = counts[11];
+	statistics_.sum_cache_hit_sizes_ = counts[12];
+	return true;
 }
 
 SOLVER_StateT Solver::countSAT() {
@@ -175,9 +723,15 @@ SOLVER_StateT Solver::countSAT() {
 
 	while (true) {
 		while (comp_manager_.findNextRemainingComponentOf(stack_.top())) {
-			decideLiteral();
-			if (stopwatch_.timeBoundBroken())
+			// a checkpoint saves the search in this state, from which
+			// countSAT() resumes, as the line above is repeatable
+			if (stopwatch_.timeBoundBroken() || interrupted())
 				return SOLVER_StateT::TIMEOUT;
+			if (parallel_counter_)
+				dispatchRemainingComponentsOf(stack_.top());
+			decideLiteral();
+			if (parallel_counter_ && abandonBranchesWithUnsatComponents())
+				break;
 			if (stopwatch_.interval_tick())
 				printOnlineStats();
 
@@ -193,12 +747,16 @@ SOLVER_StateT Solver::countSAT() {
 		state = backtrack();
 		if (state == retStateT::EXIT)
 			return SOLVER_StateT::SUCCESS;
+		if (state == retStateT::ABORT)
+			return SOLVER_StateT::TIMEOUT;
 		while (state != retStateT::PROCESS_COMPONENT && !bcp()) {
 			state = resolveConflict();
 			if (state == retStateT::BACKTRACK) {
 				state = backtrack();
 				if (state == retStateT::EXIT)
 					return SOLVER_StateT::SUCCESS;
+				if (state == retStateT::ABORT)
+					return SOLVER_StateT::TIMEOUT;
 			}
 		}
 	}
@@ -214,13 +772,19 @@ void Solver::decideLiteral() {
 	float max_score = -1;
 	float score;
 	VariableIndex max_score_var(0);
+	// projection variables are branched on first
+	bool max_in_projection = false;
 	for (auto it =
 			comp_manager_.superComponentOf(stack_.top()).varsBegin();
 			it->get<VariableIndex>() != varsSENTINEL; it++) {
+		bool in_projection = inProjection(it->get<VariableIndex>());
+		if (max_in_projection && !in_projection)
+			continue;
 		score = scoreOf(it->get<VariableIndex>());
-		if (score > max_score) {
+		if (score > max_score || in_projection != max_in_projection) {
 			max_score = score;
 			max_score_var = it->get<VariableIndex>();
+			max_in_projection = in_projection;
 		}
 	}
 	// this assert should always hold,
@@ -233,6 +797,10 @@ void Solver::decideLiteral() {
 
 	setLiteralIfFree(theLit);
 	statistics_.num_decisions_++;
+	if (marginal_stack_)
+		marginal_stack_->push();
+	if (nnf_trace_)
+		nnf_trace_->push();
 
 	if (statistics_.num_decisions_ % 128 == 0)
 //    if (statistics_.num_conflicts_ % 128 == 0)
@@ -246,12 +814,25 @@ retStateT Solver::backtrack() {
 	assert(
 			stack_.top().remaining_components_ofs() <= comp_manager_.component_stack_size());
 	do {
+		if (stack_.top().anotherCompProcessible())
+			return retStateT::PROCESS_COMPONENT;
+		if (!joinDispatchedComponentsOf(stack_.top()))
+			return retStateT::ABORT;
 		if (stack_.top().branch_found_unsat())
 			comp_manager_.removeAllCachePollutionsOf(stack_.top());
-		else if (stack_.top().anotherCompProcessible())
-			return retStateT::PROCESS_COMPONENT;
 
-		if (!stack_.top().isSecondBranch()) {
+		if (marginal_stack_)
+			finishMarginalsOfBranch();
+		if (nnf_trace_)
+			nnf_trace_->finishBranch(comp_manager_.superComponentOf(stack_.top()),
+					stack_.top().isSecondBranch(),
+					stack_.top().getActiveBranchModelCount() == 0, literal_values_);
+
+		// the super component holds no projection variable, if the decision
+		// variable is none, hence a model in the first branch suffices
+		if (!stack_.top().isSecondBranch()
+				&& (inProjection(TOS_decLit().var())
+						|| stack_.top().getTotalModelCount() == 0)) {
 			LiteralID aLit = TOS_decLit();
 			assert(stack_.get_decision_level() > 0);
 			stack_.top().changeBranch();
@@ -262,13 +843,28 @@ retStateT Solver::backtrack() {
 		// OTHERWISE:  backtrack further
 		comp_manager_.cacheModelCountOf(stack_.top().super_component(),
 				stack_.top().getTotalModelCount());
+		if (marginal_stack_)
+			comp_manager_.cacheMarginalsOf(stack_.top().super_component(),
+					marginal_stack_->marginals());
 
 		if (stack_.get_decision_level() <= 0)
 			break;
+		if (nnf_trace_) {
+			unsigned node = nnf_trace_->pop(TOS_decLit().var());
+			comp_manager_.cacheNnfNodeOf(stack_.top().super_component(), node);
+			nnf_trace_->includeNode(node);
+		}
 		reactivateTOS();
 
 		assert(stack_.size()>=2);
 		(stack_.end() - 2)->includeSolution(stack_.top().getTotalModelCount());
+		if (marginal_stack_) {
+			// the popped level keeps its marginals until the next push()
+			const vector<ModelCount> &marginals = marginal_stack_->marginals();
+			marginal_stack_->pop();
+			marginal_stack_->includeComponent(stack_.top().getTotalModelCount(),
+					comp_manager_.superComponentOf(stack_.top()), marginals);
+		}
 		stack_.pop_back();
 		// step to the next component not yet processed
 		stack_.top().nextUnprocessedComponent();
@@ -280,6 +876,99 @@ retStateT Solver::backtrack() {
 	return retStateT::EXIT;
 }
 
+void Solver::dispatchRemainingComponentsOf(StackLevel &top) {
+	DispatchedComponents dispatched;
+	comp_manager_.detachRemainingCompsOf(top,
+			config_.parallel_min_component_vars, dispatched.comp_ids);
+	if (dispatched.comp_ids.empty())
+		return;
+
+	vector<Component> comps;
+	for (auto id : dispatched.comp_ids)
+		comps.push_back(comp_manager_.componentAt(id));
+	dispatched.stack_size = stack_.size();
+	dispatched.batch = parallel_counter_->dispatch(literal_stack_, move(comps));
+	statistics_.num_dispatched_components_ += dispatched.comp_ids.size();
+	dispatched_.push_back(move(dispatched));
+}
+
+bool Solver::abandonBranchesWithUnsatComponents() {
+	auto it = dispatched_.begin();
+	while (it != dispatched_.end() && !it->batch->found_unsat())
+		it++;
+	if (it == dispatched_.end())
+		return false;
+
+	// the counts of all levels above are of no use anymore
+	unsigned stack_size = it->stack_size;
+	while (stack_.size() > stack_size) {
+		if (dispatched_.back().stack_size == stack_.size()) {
+			dispatched_.back().batch->cancel();
+			dispatched_.pop_back();
+		}
+		reactivateTOS();
+		stack_.pop_back();
+	}
+	stack_.top().includeSolution(0);
+	return true;
+}
+
+bool Solver::joinDispatchedComponentsOf(StackLevel &top) {
+	if (dispatched_.empty() || dispatched_.back().stack_size != stack_.size())
+		return true;
+	auto &dispatched = dispatched_.back();
+	// no need to wait for the counts of an unsatisfiable branch
+	if (top.branch_found_unsat())
+		dispatched.batch->cancel();
+
+	while (!dispatched.batch->waitFor(100))
+		if (stopwatch_.timeBoundBroken() || interrupted())
+			return false;
+
+	if (!top.branch_found_unsat()) {
+		if (!dispatched.batch->succeeded())
+			return false;
+		for (unsigned slot = 0; slot < dispatched.comp_ids.size(); slot++) {
+			const ModelCount &count = dispatched.batch->count(slot);
+			comp_manager_.cacheModelCountOf(dispatched.comp_ids[slot], count);
+			top.includeSolution(count);
+		}
+	}
+	dispatched_.pop_back();
+	return true;
+}
+
+void Solver::cancelDispatchedComponents() {
+	for (auto &dispatched : dispatched_)
+		dispatched.batch->cancel();
+	// workers do not outlive the batches, the counter waits for them
+	dispatched_.clear();
+}
+
+bool Solver::countComponent(const vector<LiteralID> &assignment,
+		const Component &comp, const atomic<bool> *interrupt,
+		ModelCount &count) {
+	initStack(num_variables());
+	interrupt_ = interrupt;
+	for (auto lit : assignment)
+		setLiteralIfFree(lit);
+	bool consistent = BCP(0);
+	assert(consistent);
+	(void) consistent;
+
+	violated_clause.reserve(num_variables());
+	comp_manager_.initialize(literals_, literal_pool_, comp);
+
+	statistics_.exit_state_ = countSAT();
+	cancelDispatchedComponents();
+	interrupt_ = nullptr;
+	if (statistics_.exit_state_ != SOLVER_StateT::SUCCESS)
+		return false;
+	count = stack_.top().getTotalModelCount();
+	comp_manager_.publishCachedModelCounts();
+	return true;
+}
+
 retStateT Solver::resolveConflict() {
 	recordLastUIPCauses();
 
@@ -320,7 +1009,10 @@ retStateT Solver::resolveConflict() {
 	// this is because we might have checked a literal
 	// during implict BCP which has been a failed literal
 	// due only to assignments made at lower decision levels
-	if (uip_clauses_.back().front() == TOS_decLit().neg()) {
+	// the clause is empty if the conflict is due to unit clauses
+	// learned on this decision level only
+	if (!uip_clauses_.back().empty()
+			&& uip_clauses_.back().front() == TOS_decLit().neg()) {
 		assert(TOS_decLit().neg() == uip_clauses_.back()[0]);
 		var(TOS_decLit().neg()).ante = addUIPConflictClause(
 				uip_clauses_.back());
@@ -346,6 +1038,10 @@ retStateT Solver::resolveConflict() {
 	assert(
 			stack_.top().remaining_components_ofs() == comp_manager_.component_stack_size());
 
+	if (marginal_stack_)
+		marginal_stack_->discardBranch();
+	if (nnf_trace_)
+		nnf_trace_->discardBranch();
 	stack_.top().changeBranch();
 	LiteralID lit = TOS_decLit();
 	reactivateTOS();
@@ -492,34 +1188,32 @@ bool Solver::BCP(size_t start_at_stack_ofs) {
 
 // this is IBCP 30.08
 bool Solver::implicitBCP() {
-	static vector<LiteralID> test_lits(num_variables());
-	static LiteralIndexedVector<unsigned char> viewed_lits(num_variables() + 1,
-			0);
+	viewed_lits_.resize(num_variables() + 1, 0);
 
 	unsigned stack_ofs = stack_.top().literal_stack_ofs();
 	unsigned num_curr_lits = 0;
 	while (stack_ofs < literal_stack_.size()) {
-		test_lits.clear();
+		test_lits_.clear();
 		for (auto it = literal_stack_.begin() + stack_ofs;
 				it != literal_stack_.end(); it++) {
 			for (auto cl_ofs : occurrence_lists_[it->neg()])
 				if (!isSatisfied(cl_ofs)) {
 					for (auto lt = beginOf(cl_ofs); *lt != SENTINEL_LIT; lt++)
-						if (isActive(*lt) && !viewed_lits[lt->neg()]) {
-							test_lits.push_back(lt->neg());
-							viewed_lits[lt->neg()] = true;
+						if (isActive(*lt) && !viewed_lits_[lt->neg()]) {
+							test_lits_.push_back(lt->neg());
+							viewed_lits_[lt->neg()] = true;
 
 						}
 				}
 		}
 		num_curr_lits = literal_stack_.size() - stack_ofs;
 		stack_ofs = literal_stack_.size();
-		for (auto jt = test_lits.begin(); jt != test_lits.end(); jt++)
-			viewed_lits[*jt] = false;
+		for (auto jt = test_lits_.begin(); jt != test_lits_.end(); jt++)
+			viewed_lits_[*jt] = false;
 
 		vector<float> scores;
 		scores.clear();
-		for (auto jt = test_lits.begin(); jt != test_lits.end(); jt++) {
+		for (auto jt = test_lits_.begin(); jt != test_lits_.end(); jt++) {
 			scores.push_back(literal(*jt).activity_score_);
 		}
 		sort(scores.begin(), scores.end());
@@ -529,9 +1223,9 @@ bool Solver::implicitBCP() {
 			threshold = scores[scores.size() - num_curr_lits];
 		}
 
-		statistics_.num_failed_literal_tests_ += test_lits.size();
+		statistics_.num_failed_literal_tests_ += test_lits_.size();
 
-		for (auto lit : test_lits)
+		for (auto lit : test_lits_)
 			if (isActive(lit) && threshold <= literal(lit).activity_score_) {
 				unsigned sz = literal_stack_.size();
 				// we increase the decLev artificially
@@ -611,8 +1305,7 @@ bool Solver::implicitBCP() {
 void Solver::minimizeAndStoreUIPClause(LiteralID uipLit,
 		vector<LiteralID> & tmp_clause,
 		const VariableIndexedVector<bool>& seen) {
-	static deque<LiteralID> clause;
-	clause.clear();
+	minimized_clause_.clear();
 	assertion_level_ = 0;
 	for (auto lit : tmp_clause) {
 		if (existsUnitClauseOf(lit.var()))
@@ -636,9 +1329,9 @@ void Solver::minimizeAndStoreUIPClause(LiteralID uipLit,
 			// uipLit should be the sole literal of this Decision Level
 			if (var(lit).decision_level >= assertion_level_) {
 				assertion_level_ = var(lit).decision_level;
-				clause.push_front(lit);
+				minimized_clause_.push_front(lit);
 			} else
-				clause.push_back(lit);
+				minimized_clause_.push_back(lit);
 		}
 	}
 
@@ -647,8 +1340,8 @@ void Solver::minimizeAndStoreUIPClause(LiteralID uipLit,
 
 	//assert(uipLit.var() != 0);
 	if (uipLit.var() != VariableIndex(0))
-		clause.push_front(uipLit);
-	uip_clauses_.push_back(vector<LiteralID>(clause.begin(), clause.end()));
+		minimized_clause_.push_front(uipLit);
+	uip_clauses_.push_back(vector<LiteralID>(minimized_clause_.begin(), minimized_clause_.end()));
 }
 
 void Solver::recordLastUIPCauses() {
@@ -662,8 +1355,7 @@ void Solver::recordLastUIPCauses() {
     //        as the number of variables should remain constant after init
     VariableIndexedVector<bool> seen(num_variables() + 1);
 
-	static vector<LiteralID> tmp_clause;
-	tmp_clause.clear();
+	tmp_clause_.clear();
 
 	assertion_level_ = 0;
 	uip_clauses_.clear();
@@ -676,7 +1368,7 @@ void Solver::recordLastUIPCauses() {
 		if (var(l).decision_level == 0 || existsUnitClauseOf(l.var()))
 			continue;
 		if (var(l).decision_level < DL)
-			tmp_clause.push_back(l);
+			tmp_clause_.push_back(l);
 		else
 			lits_at_current_dl++;
 		literal(l).increaseActivity();
@@ -718,7 +1410,7 @@ void Solver::recordLastUIPCauses() {
 						|| existsUnitClauseOf(it->var()))
 					continue;
 				if (var(*it).decision_level < DL)
-					tmp_clause.push_back(*it);
+					tmp_clause_.push_back(*it);
 				else
 					lits_at_current_dl++;
 				seen[it->var()] = true;
@@ -730,7 +1422,7 @@ void Solver::recordLastUIPCauses() {
 			if (!seen[alit.var()] && !(var(alit).decision_level == 0)
 					&& !existsUnitClauseOf(alit.var())) {
 				if (var(alit).decision_level < DL)
-					tmp_clause.push_back(alit);
+					tmp_clause_.push_back(alit);
 				else
 					lits_at_current_dl++;
 				seen[alit.var()] = true;
@@ -742,7 +1434,7 @@ void Solver::recordLastUIPCauses() {
 //	cout << "T" << curr_lit.toInt() << "U "
 //     << var(curr_lit).decision_level << ", " << stack_.get_decision_level() << endl;
 //	cout << "V"  << var(curr_lit).ante.isAnt() << " "  << endl;
-	minimizeAndStoreUIPClause(curr_lit.neg(), tmp_clause, seen);
+	minimizeAndStoreUIPClause(curr_lit.neg(), tmp_clause_, seen);
 
 //	if (var(curr_lit).decision_level > assertion_level_)
 //		assertion_level_ = var(curr_lit).decision_level;
@@ -758,8 +1450,7 @@ void Solver::recordAllUIPCauses() {
     //        as the number of variables should remain constant after init
     VariableIndexedVector<bool> seen(num_variables() + 1);
 
-	static vector<LiteralID> tmp_clause;
-	tmp_clause.clear();
+	tmp_clause_.clear();
 
 	assertion_level_ = 0;
 	uip_clauses_.clear();
@@ -772,7 +1463,7 @@ void Solver::recordAllUIPCauses() {
 		if (var(l).decision_level == 0 || existsUnitClauseOf(l.var()))
 			continue;
 		if (var(l).decision_level < DL)
-			tmp_clause.push_back(l);
+			tmp_clause_.push_back(l);
 		else
 			lits_at_current_dl++;
 		literal(l).increaseActivity();
@@ -798,7 +1489,7 @@ void Solver::recordAllUIPCauses() {
 				break;
 			}
 			// perform UIP stuff
-			minimizeAndStoreUIPClause(curr_lit.neg(), tmp_clause, seen);
+			minimizeAndStoreUIPClause(curr_lit.neg(), tmp_clause_, seen);
 		}
 
 		assert(hasAntecedent(curr_lit));
@@ -813,7 +1504,7 @@ void Solver::recordAllUIPCauses() {
 						|| existsUnitClauseOf(it->var()))
 					continue;
 				if (var(*it).decision_level < DL)
-					tmp_clause.push_back(*it);
+					tmp_clause_.push_back(*it);
 				else
 					lits_at_current_dl++;
 				seen[it->var()] = true;
@@ -825,7 +1516,7 @@ void Solver::recordAllUIPCauses() {
 			if (!seen[alit.var()] && !(var(alit).decision_level == 0)
 					&& !existsUnitClauseOf(alit.var())) {
 				if (var(alit).decision_level < DL)
-					tmp_clause.push_back(alit);
+					tmp_clause_.push_back(alit);
 				else
 					lits_at_current_dl++;
 				seen[alit.var()] = true;
@@ -833,7 +1524,7 @@ void Solver::recordAllUIPCauses() {
 		}
 	}
 	if (!hasAntecedent(curr_lit)) {
-		minimizeAndStoreUIPClause(curr_lit.neg(), tmp_clause, seen);
+		minimizeAndStoreUIPClause(curr_lit.neg(), tmp_clause_, seen);
 	}
 //	if (var(curr_lit).decision_level > assertion_level_)
 //		assertion_level_ = var(curr_lit).decision_level;
@@ -67,6 +67,16 @@ void DataAndStatistics::printShort() {
 
   cout << "implicit BCP miss rate \t " << implicitBCP_miss_rate() * 100 << "%";
   cout << endl;
+  cout << "components counted by workers \t" << num_dispatched_components_
+      << endl;
+  if (shared_cache_statistics_) {
+    cout << "shared cache (stores / hits / look ups) \t"
+        << shared_cache_statistics_->num_stores_ << "/"
+        << shared_cache_statistics_->num_hits_ << "/"
+        << shared_cache_statistics_->num_look_ups_ << endl;
+    cout << "bytes shared cache \t"
+        << shared_cache_statistics_->bytes_memory_usage_ << endl;
+  }
   cout << "bytes cache size     \t" << cache_bytes_memory_usage()  << "\t"
       << endl;
 
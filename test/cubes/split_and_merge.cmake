@@ -0,0 +1,23 @@
+# Splits INPUT into cubes in CUBE_DIR, counts each cube with SHARPSAT
+# and prints the merged count.
+#
+# cmake -DSHARPSAT=... -DINPUT=... -DDEPTH=... -DCUBE_DIR=... -P split_and_merge.cmake
+
+file(REMOVE_RECURSE "${CUBE_DIR}")
+file(MAKE_DIRECTORY "${CUBE_DIR}")
+
+execute_process(COMMAND "${SHARPSAT}" -q -split ${DEPTH} "${CUBE_DIR}" "${INPUT}"
+    RESULT_VARIABLE RESULT)
+if (NOT RESULT EQUAL 0)
+    message(FATAL_ERROR "Splitting ${INPUT} failed")
+endif()
+
+file(GLOB CUBE_FILES "${CUBE_DIR}/cube_*.cnf")
+foreach(CUBE_FILE ${CUBE_FILES})
+    string(REGEX REPLACE "\\.cnf$" ".txt" RESULT_FILE "${CUBE_FILE}")
+    execute_process(COMMAND "${SHARPSAT}" "${CUBE_FILE}"
+        OUTPUT_FILE "${RESULT_FILE}")
+endforeach()
+
+execute_process(COMMAND "${SHARPSAT}" -merge "${CUBE_DIR}")
+file(REMOVE_RECURSE "${CUBE_DIR}")